@@ -0,0 +1,96 @@
+﻿/*
+  alloc_counter.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+
+
+namespace {
+	std::atomic<size_t> allocationCount{ 0 };
+	std::atomic<size_t> allocatedBytes{ 0 };
+	std::atomic<size_t> freeCount{ 0 };
+
+#ifdef DANK_COUNT_ALLOCATIONS
+	void* countedAlloc(size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		void* ptr = malloc(size == 0 ? 1 : size);
+		if (ptr == nullptr)
+			throw std::bad_alloc();
+		return ptr;
+	}
+
+	void countedFree(void* ptr)
+	{
+		if (ptr == nullptr)
+			return;
+		freeCount.fetch_add(1, std::memory_order_relaxed);
+		free(ptr);
+	}
+#endif
+}
+
+size_t getAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+size_t getAllocatedBytes()
+{
+	return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+size_t getLiveAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed) - freeCount.load(std::memory_order_relaxed);
+}
+
+size_t getPeakResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return size_t(usage.ru_maxrss) * 1024; // kilobytes on Linux
+#endif
+}
+
+#ifdef DANK_COUNT_ALLOCATIONS
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+
+#endif
@@ -0,0 +1,35 @@
+﻿/*
+  alloc_counter.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+
+
+// Built with DANK_COUNT_ALLOCATIONS (msbuild /p:DankBenchmark=true), alloc_counter.cpp
+// replaces the global operator new/delete with versions that count every heap allocation,
+// so benchmarks can check that a hot path does not allocate. Without it the counts stay 0
+// and the game pays nothing for them.
+#ifdef DANK_COUNT_ALLOCATIONS
+constexpr bool isCountingAllocations = true;
+#else
+constexpr bool isCountingAllocations = false;
+#endif
+
+size_t getAllocationCount();
+size_t getAllocatedBytes();
+// allocations not freed yet, for checking that something does not grow over time
+size_t getLiveAllocationCount();
+// most physical memory the process has held at once, as the OS counts it
+size_t getPeakResidentBytes();
@@ -0,0 +1,157 @@
+﻿/*
+  asset_loader.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "asset_loader.h"
+#include "variables.h"
+#include "profiler.h"
+#include <algorithm>
+#include <iostream>
+
+
+
+void AssetLoader::request(assetKind kind, const std::string& filePath)
+{
+	if (!requested.emplace(filePath, kind).second)
+		return;
+
+	if (workers.empty())
+		startWorkers();
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		jobs.push_back(LoadJob{ kind, filePath });
+	}
+	wakeUp.notify_one();
+}
+
+// Threads are only started by the first request, so the headless and benchmark modes never get any
+void AssetLoader::startWorkers()
+{
+	const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	const unsigned int workerCount = std::clamp(hardwareThreads > 1 ? hardwareThreads - 1 : 1u, 1u, maxWorkers);
+
+	isStopping = false;
+	for (unsigned int i = 0; i < workerCount; i++)
+		workers.emplace_back(&AssetLoader::workerLoop, this);
+}
+
+void AssetLoader::workerLoop()
+{
+	PROFILE_THREAD("asset loader");
+
+	for (;;) {
+		LoadedAsset asset;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wakeUp.wait(guard, [this] { return isStopping || !jobs.empty(); });
+			if (isStopping)
+				return;
+			asset.job = std::move(jobs.front());
+			jobs.pop_front();
+			decodingCount++;
+		}
+
+		{
+			PROFILE_SCOPE("AssetLoader::decode");
+			decode(asset);
+		}
+
+		std::lock_guard<std::mutex> guard(lock);
+		finished.push_back(std::move(asset));
+		decodingCount--;
+	}
+}
+
+// Worker side, disk and CPU only
+void AssetLoader::decode(LoadedAsset& asset)
+{
+	if (asset.job.kind == assetKind::TEXTURE) {
+		asset.isLoaded = asset.image.LoadFromPNG(asset.job.filePath);
+		return;
+	}
+
+	sf::InputSoundFile file;
+	if (!file.openFromFile(asset.job.filePath))
+		return;
+
+	asset.channelCount = file.getChannelCount();
+	asset.sampleRate = file.getSampleRate();
+	asset.samples.resize(static_cast<size_t>(file.getSampleCount()));
+	asset.samples.resize(static_cast<size_t>(file.read(asset.samples.data(), asset.samples.size())));
+	asset.isLoaded = true;
+}
+
+void AssetLoader::pump()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (finished.empty())
+			return;
+		uploading.swap(finished);
+	}
+
+	for (LoadedAsset& asset : uploading)
+		upload(asset);
+	uploading.clear();
+}
+
+// Main thread side, the only part that talks to OpenGL / OpenAL
+void AssetLoader::upload(LoadedAsset& asset)
+{
+	if (!asset.isLoaded) {
+		std::cout << "Asset load failed :( " << asset.job.filePath << "\n";
+		return;
+	}
+
+	if (asset.job.kind == assetKind::TEXTURE) {
+		doodle::Texture& texture = textures[asset.job.filePath];
+		texture.LoadFromImage(asset.image);
+		texture.SetSmooth(true);
+	}
+	else
+		soundCache.insertDecoded(asset.job.filePath, asset.samples.data(), asset.samples.size(), asset.channelCount, asset.sampleRate);
+}
+
+const doodle::Texture* AssetLoader::getTexture(const std::string& filePath)
+{
+	auto found = textures.find(filePath);
+	if (found != textures.end())
+		return &found->second;
+
+	request(assetKind::TEXTURE, filePath);
+	return nullptr;
+}
+
+bool AssetLoader::isIdle() const
+{
+	return getPendingCount() == 0;
+}
+
+size_t AssetLoader::getPendingCount() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return jobs.size() + decodingCount + finished.size();
+}
+
+void AssetLoader::shutdown()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		isStopping = true;
+	}
+	wakeUp.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+}
@@ -0,0 +1,90 @@
+﻿/*
+  asset_loader.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <doodle/image.hpp>
+#include <doodle/texture.hpp>
+#include "SFML/Audio.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+
+enum class assetKind {
+	TEXTURE, SOUND
+};
+
+// Reads and decodes PNG and WAV files on a few worker threads. What only the main
+// thread may do, creating the GL texture or the OpenAL buffer, waits in a queue until
+// pump() is called from the game loop. Finished textures live here, sounds go into
+// soundCache, so a state that asks for either afterwards never touches the disk.
+class AssetLoader
+{
+public:
+	static constexpr unsigned int maxWorkers = 4;
+
+	~AssetLoader() { shutdown(); }
+
+	void request(assetKind kind, const std::string& filePath);
+
+	// Main thread only, once per frame. Uploads whatever the workers have finished.
+	void pump();
+
+	// nullptr until it is uploaded, asks for it if nobody has yet
+	const doodle::Texture* getTexture(const std::string& filePath);
+
+	// nothing queued, decoding or waiting for upload
+	bool isIdle() const;
+	size_t getPendingCount() const;
+
+	void shutdown();
+
+private:
+	struct LoadJob {
+		assetKind kind = assetKind::TEXTURE;
+		std::string filePath;
+	};
+
+	struct LoadedAsset {
+		LoadJob job;
+		bool isLoaded = false;
+		doodle::Image image;
+		std::vector<sf::Int16> samples;
+		unsigned int channelCount = 0;
+		unsigned int sampleRate = 0;
+	};
+
+	void startWorkers();
+	void workerLoop();
+	static void decode(LoadedAsset& asset);
+	void upload(LoadedAsset& asset);
+
+	std::vector<std::thread> workers;
+	mutable std::mutex lock;
+	std::condition_variable wakeUp;
+	std::deque<LoadJob> jobs;
+	std::vector<LoadedAsset> finished;
+	size_t decodingCount = 0;
+	bool isStopping = false;
+
+	// main thread only
+	std::unordered_map<std::string, assetKind> requested;
+	std::unordered_map<std::string, doodle::Texture> textures;
+	std::vector<LoadedAsset> uploading;
+};
@@ -13,45 +13,58 @@
 
 #pragma once
 
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
 #include <vector>
-using std::vector;
+using std::vector; // not used here anymore, but most of the game gets it through this header
+
 
 
+// Everything in here is header only so it inlines into the hot loops, and nothing allocates.
 
 struct Vector {
-	Vector(float x, float y) :x(x), y(y) {}
-	Vector() {}
+	constexpr Vector(float x, float y) :x(x), y(y) {}
+	constexpr Vector() {}
 	float x{ 0.0f };
 	float y{ 0.0f };
 
-	Vector operator+(const Vector& vector)const;
-	Vector operator-(const Vector& vector)const;
-	Vector operator*(const float& vector)const;
-	Vector operator/(const float& vector)const;
+	constexpr Vector operator+(const Vector& vector)const { return Vector(x + vector.x, y + vector.y); }
+	constexpr Vector operator-(const Vector& vector)const { return Vector(x - vector.x, y - vector.y); }
+	constexpr Vector operator*(const float& floatParam)const { return Vector(x * floatParam, y * floatParam); }
+	constexpr Vector operator/(const float& floatParam)const { return Vector(x / floatParam, y / floatParam); }
 
-	Vector& operator+=(const Vector& vector);
-	Vector& operator-=(const Vector& vector);
-	Vector& operator*=(const float& floatParam);
-	Vector& operator= (const Vector& vector);
+	constexpr Vector& operator+=(const Vector& vector) { x += vector.x; y += vector.y; return *this; }
+	constexpr Vector& operator-=(const Vector& vector) { x -= vector.x; y -= vector.y; return *this; }
+	constexpr Vector& operator*=(const float& floatParam) { x *= floatParam; y *= floatParam; return *this; }
 
-	float cross(const Vector& vector)const;
+	constexpr float cross(const Vector& vector)const { return x * vector.y - y * vector.x; }
 
-	float operator*(const Vector& vector);
-	float operator*(const Vector& vector)const;
+	constexpr float operator*(const Vector& vector)const { return x * vector.x + y * vector.y; }
 
-	void toUnitVec();
-	Vector getUnitVec();
-	float length()const;
-	float sqrLength()const;
+	void toUnitVec() { *this = getUnitVec(); }
+	Vector getUnitVec() const { const float len = length(); return Vector(x / len, y / len); }
+	float length()const { return sqrtf(x * x + y * y); }
+	constexpr float sqrLength()const { return x * x + y * y; }
 };
 
 
-void rotateVector(Vector& vector, const float radianDegrees);
+inline void rotateVector(Vector& vector, const float radian)
+{
+	vector.x = cosf(radian) * vector.x - sinf(radian) * vector.y;
+	vector.y = sinf(radian) * vector.x + cosf(radian) * vector.y;
+	vector.toUnitVec();
+}
 
-float returnVectorLength(const Vector& vector);
+inline float returnVectorLength(const Vector& vector)
+{
+	return vector.length();
+}
 
 template<typename T>
-inline T lerp(T Start, T end, float point)
+constexpr T lerp(T Start, T end, float point)
 {
 	if (point > 1.0f || point < 0.0f)
 	{
@@ -60,21 +73,103 @@ inline T lerp(T Start, T end, float point)
 	return T(Start + (end - Start) * point);
 }
 
-bool get_Intersect_Point_From_2_Lines(const Vector& p1, const Vector& p2, const Vector& p3, const Vector& p4, Vector& intersectingPoint);
+constexpr bool get_Intersect_Point_From_2_Lines(const Vector& p1, const Vector& p2, const Vector& p3, const Vector& p4, Vector& intersectingPoint)
+{
+	const Vector line1Dir(p2 - p1);
+	const Vector line2Dir(p4 - p3);
+	const Vector perp_p1p2 = Vector(-line1Dir.y, line1Dir.x);
+	const Vector perp_p3p4 = Vector(-line2Dir.y, line2Dir.x);
+	const float t = (p1 - p3) * perp_p1p2 / (line2Dir * perp_p1p2);
+	const float s = (p3 - p1) * perp_p3p4 / (line1Dir * perp_p3p4);
+
+	if (t > 0.f && t < 1.f && s > 0.f && s < 1.f)
+	{
+		intersectingPoint = p1 + line1Dir * s;
+		return true;
+	}
+
+	return false;
+}
 
 class Line
 {
 public:
-	Line(const Vector& p1, const Vector& p2);
-	vector<Vector> getPoints() const;
-	Vector getDirectionVector() const;
-	float getLength()const;
-	float getLengthSqr()const;
+	constexpr Line() {}
+	constexpr Line(const Vector& p1, const Vector& p2) :p1(p1), p2(p2) {}
+
+	// returned by value, bind the element to a Vector rather than a reference
+	constexpr std::array<Vector, 2> getPoints() const { return { p1, p2 }; }
+	constexpr const Vector& getP1() const { return p1; }
+	constexpr const Vector& getP2() const { return p2; }
+
+	constexpr Vector getDirectionVector() const { return p2 - p1; }
+	float getLength()const { return getDirectionVector().length(); }
+	constexpr float getLengthSqr()const { return getDirectionVector().sqrLength(); }
+
+	constexpr Line translated(const Vector& offset) const { return Line(p1 + offset, p2 + offset); }
 private:
 	Vector p1;
 	Vector p2;
 };
 
-bool get_Intersect_Point_From_2_Lines(const Line& line_1,const Line& line_2, Vector& intersectingPoint);
+constexpr bool get_Intersect_Point_From_2_Lines(const Line& line_1, const Line& line_2, Vector& intersectingPoint)
+{
+	const Vector line1 = line_1.getDirectionVector();
+	const Vector line2 = line_2.getDirectionVector();
+	const Vector& p1 = line_1.getP1();
+	const Vector& p3 = line_2.getP1();
+
+	const float parallelDet = line1.cross(line2);
+
+	if (parallelDet < FLT_EPSILON && parallelDet > -FLT_EPSILON)
+		return false;
+
+	const float t = (p3 - p1).cross(line2) / parallelDet;
 
-Vector projected_Point_On_Line(const Vector& p, const Line& line);
\ No newline at end of file
+	// same as t > line1.length(), squared so it stays constexpr
+	if (t > 0.f && t * t > line1.sqrLength())
+		return false;
+
+	intersectingPoint = p1 + line1 * t;
+	return true;
+}
+
+constexpr Vector projected_Point_On_Line(const Vector& p, const Line& line)
+{
+	const Vector& line_p1 = line.getP1();
+	const Vector lineDir = line.getDirectionVector();
+	return line_p1 + lineDir * (((p - line_p1) * lineDir) / line.getLengthSqr());
+}
+
+constexpr size_t maxPolygonEdges = 16;
+
+// Closed outline of up to maxPolygonEdges lines, stored inline
+class Polygon
+{
+public:
+	constexpr void push_back(const Line& edge)
+	{
+		if (edgeCount < maxPolygonEdges)
+			edges[edgeCount++] = edge;
+	}
+	constexpr void clear() { edgeCount = 0; }
+
+	constexpr size_t size() const { return edgeCount; }
+	constexpr bool empty() const { return edgeCount == 0; }
+
+	constexpr const Line& operator[](size_t i) const { return edges[i]; }
+	constexpr const Line* begin() const { return edges.data(); }
+	constexpr const Line* end() const { return edges.data() + edgeCount; }
+
+	constexpr Polygon translated(const Vector& offset) const
+	{
+		Polygon result;
+		for (size_t i = 0; i < edgeCount; i++)
+			result.edges[i] = edges[i].translated(offset);
+		result.edgeCount = edgeCount;
+		return result;
+	}
+private:
+	std::array<Line, maxPolygonEdges> edges{};
+	size_t edgeCount = 0;
+};
@@ -0,0 +1,181 @@
+﻿/*
+  batch_projection.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "batch_projection.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PROJECTION_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define PROJECTION_X86 0
+#endif
+
+// MSVC lets any function use any intrinsic, GCC and Clang need to be told per function
+#if PROJECTION_X86 && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE
+#define TARGET_AVX2
+#endif
+
+
+
+namespace {
+
+	void projectScalar(const float* posX, const float* posY, size_t begin, size_t count,
+		float originX, float originY, float basisX, float basisY,
+		float* outX, float* outY)
+	{
+		for (size_t i = begin; i < count; i++) {
+			const float dx = posX[i] - originX;
+			const float dy = posY[i] - originY;
+			outX[i] = dx * basisY - dy * basisX;
+			outY[i] = dx * basisX + dy * basisY;
+		}
+	}
+
+#if PROJECTION_X86
+
+	TARGET_SSE
+	void projectSSE(const float* posX, const float* posY, size_t count,
+		float originX, float originY, float basisX, float basisY,
+		float* outX, float* outY)
+	{
+		const __m128 ox = _mm_set1_ps(originX);
+		const __m128 oy = _mm_set1_ps(originY);
+		const __m128 bx = _mm_set1_ps(basisX);
+		const __m128 by = _mm_set1_ps(basisY);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128 dx = _mm_sub_ps(_mm_loadu_ps(posX + i), ox);
+			const __m128 dy = _mm_sub_ps(_mm_loadu_ps(posY + i), oy);
+			_mm_storeu_ps(outX + i, _mm_sub_ps(_mm_mul_ps(dx, by), _mm_mul_ps(dy, bx)));
+			_mm_storeu_ps(outY + i, _mm_add_ps(_mm_mul_ps(dx, bx), _mm_mul_ps(dy, by)));
+		}
+
+		projectScalar(posX, posY, i, count, originX, originY, basisX, basisY, outX, outY);
+	}
+
+	TARGET_AVX2
+	void projectAVX2(const float* posX, const float* posY, size_t count,
+		float originX, float originY, float basisX, float basisY,
+		float* outX, float* outY)
+	{
+		const __m256 ox = _mm256_set1_ps(originX);
+		const __m256 oy = _mm256_set1_ps(originY);
+		const __m256 bx = _mm256_set1_ps(basisX);
+		const __m256 by = _mm256_set1_ps(basisY);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(posX + i), ox);
+			const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(posY + i), oy);
+			_mm256_storeu_ps(outX + i, _mm256_sub_ps(_mm256_mul_ps(dx, by), _mm256_mul_ps(dy, bx)));
+			_mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_mul_ps(dx, bx), _mm256_mul_ps(dy, by)));
+		}
+
+		projectScalar(posX, posY, i, count, originX, originY, basisX, basisY, outX, outY);
+	}
+
+	bool isAVX2Supported()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		__cpuid(info, 1);
+		const bool osSavesYMM = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+			(_xgetbv(0) & 0x6) == 0x6;
+		if (!osSavesYMM)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+#endif
+
+	projectionPath detectProjectionPath()
+	{
+#if PROJECTION_X86
+		if (isAVX2Supported())
+			return projectionPath::AVX2;
+		return projectionPath::SSE; // every x86 CPU that runs Windows 10 has SSE2
+#else
+		return projectionPath::SCALAR;
+#endif
+	}
+
+}
+
+projectionPath getProjectionPath()
+{
+	static const projectionPath path = detectProjectionPath();
+	return path;
+}
+
+const char* getProjectionPathName(projectionPath path)
+{
+	switch (path) {
+	case projectionPath::AVX2: return "avx2";
+	case projectionPath::SSE: return "sse";
+	default: return "scalar";
+	}
+}
+
+void projectBatch(const float* posX, const float* posY, size_t count,
+	float originX, float originY, float rotationX, float rotationY,
+	float* outX, float* outY)
+{
+	projectBatch(getProjectionPath(), posX, posY, count,
+		originX, originY, rotationX, rotationY, outX, outY);
+}
+
+void projectBatch(projectionPath path, const float* posX, const float* posY, size_t count,
+	float originX, float originY, float rotationX, float rotationY,
+	float* outX, float* outY)
+{
+	// Normalizing the basis once replaces the per enemy divisions and square roots
+	const float rotationLength = sqrtf(rotationX * rotationX + rotationY * rotationY);
+	const float basisX = rotationX / rotationLength;
+	const float basisY = rotationY / rotationLength;
+
+	if (path == projectionPath::AVX2 && getProjectionPath() != projectionPath::AVX2)
+		path = getProjectionPath();
+
+	switch (path) {
+#if PROJECTION_X86
+	case projectionPath::AVX2:
+		projectAVX2(posX, posY, count, originX, originY, basisX, basisY, outX, outY);
+		break;
+	case projectionPath::SSE:
+		projectSSE(posX, posY, count, originX, originY, basisX, basisY, outX, outY);
+		break;
+#endif
+	default:
+		projectScalar(posX, posY, 0, count, originX, originY, basisX, basisY, outX, outY);
+		break;
+	}
+}
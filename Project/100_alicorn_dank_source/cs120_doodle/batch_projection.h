@@ -0,0 +1,43 @@
+﻿/*
+  batch_projection.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+
+
+// Projects every enemy into the eye's view basis in one pass.
+// For an enemy at d = pos - origin and a view direction r, this writes
+//   outX = cross(d, r) / |r|   (left / right of the view line)
+//   outY = dot(d, r) / |r|     (ahead / behind)
+// which is what Eye::percept used to get from two projections, three square roots
+// and two sign tests per enemy. Inputs and outputs may be unaligned, outputs must not
+// alias inputs.
+void projectBatch(const float* posX, const float* posY, size_t count,
+	float originX, float originY, float rotationX, float rotationY,
+	float* outX, float* outY);
+
+enum class projectionPath {
+	SCALAR, SSE, AVX2
+};
+
+// The path chosen for this CPU the first time projectBatch runs
+projectionPath getProjectionPath();
+const char* getProjectionPathName(projectionPath path);
+
+// Runs one path explicitly, --bench-geometry checks each one against the old percept math.
+// Falls back to the best supported path if the requested one is not available.
+void projectBatch(projectionPath path, const float* posX, const float* posY, size_t count,
+	float originX, float originY, float rotationX, float rotationY,
+	float* outX, float* outY);
@@ -0,0 +1,616 @@
+﻿/*
+  benchmark.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "benchmark.h"
+#include "alloc_counter.h"
+#include "batch_projection.h"
+#include "classes.h"
+#include "useful_functions.h"
+#include "variables.h"
+#include "hrtf.h"
+#include "software_mixer.h"
+#include "software_renderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace {
+
+	constexpr int geometryEnemyCounts[] = { 100, 1000, 10000 };
+	constexpr float benchmarkFieldSize = 3000.0f;
+	constexpr int benchmarkRayCount = 256;
+	constexpr float projectionTolerance = 2e-6f;  // relative to the enemy's distance
+	constexpr int hrtfBenchmarkSeconds = 10;
+	constexpr int hrtfRealTimeVoices = 64;
+	constexpr float headlessFrameTime = 1.0f / 60.0f;
+	constexpr int headlessWindowSize = 820;
+	constexpr int rasterEnemyCount = 1000;
+	constexpr int rasterLineCount = 200;
+	constexpr int rasterQuadCount = 50;
+	constexpr int stressDefaultTicks = 600;
+	constexpr size_t stressEnemyCounts[] = { 100, 1000, 10000, 100000 };
+	constexpr int stressRaysPerTick = 8;  // a few cannon charges worth
+	constexpr unsigned int stressSoundRate = 44100;
+	const char* const stressSoundPath = "stress benchmark blink";
+
+	enum class stressPhase {
+		UPDATE, PERCEPTION, RAY_QUERY, AUDIO, COUNT
+	};
+	const char* const stressPhaseNames[] = { "update", "perception", "rayQuery", "audio" };
+
+	// about what a late wave in the overlay view throws at the screen, scaled to the frame
+	void drawRasterScene(Renderer& target, int width, int height)
+	{
+		std::mt19937 rng(2019);
+		std::uniform_real_distribution<float> fieldX(-width / 2.0f, width / 2.0f);
+		std::uniform_real_distribution<float> fieldY(-height / 2.0f, height / 2.0f);
+		const float scale = height / float(headlessWindowSize);
+		std::uniform_real_distribution<float> size(10.0f * scale, 150.0f * scale);
+
+		target.beginFrame();
+		target.setShapeModes(EllipseMode::Center, RectMode::Center);
+		target.pushSettings();
+
+		// the values are drawn one per statement, argument order would be up to the compiler
+		target.noOutline();
+		for (int i = 0; i < rasterEnemyCount; i++) {
+			target.setFill(HexColor{ (unsigned(rng()) & 0xFFFFFF00u) | 0x80u });
+			const float x = fieldX(rng);
+			const float y = fieldY(rng);
+			const float diameter = size(rng);
+			target.drawEllipse(x, y, diameter, diameter);
+		}
+
+		target.setOutline(defaultEdgeColor);
+		target.setOutlineWidth(defaultEdgeWidth * 2);
+		for (int i = 0; i < rasterLineCount; i++) {
+			const float x1 = fieldX(rng);
+			const float y1 = fieldY(rng);
+			const float x2 = fieldX(rng);
+			const float y2 = fieldY(rng);
+			target.drawLine(x1, y1, x2, y2);
+		}
+
+		target.setFill(red1);
+		for (int i = 0; i < rasterQuadCount; i++) {
+			const float x = fieldX(rng);
+			const float y = fieldY(rng);
+			target.drawQuad(x, y, x + 100 * scale, y, x + 130 * scale, y + 200 * scale, x - 30 * scale, y + 200 * scale);
+			target.drawTriangle(x, y, x - 20 * scale, y - 40 * scale, x + 20 * scale, y - 40 * scale);
+			target.drawRectangle(x, y, 60 * scale, 30 * scale);
+		}
+
+		target.popSettings();
+		target.endFrame();
+	}
+
+	// getFirstObjectHitByRay() before the grid: every enemy sorted by distance to the origin,
+	// the first one the ray hits wins. Kept to check and time the grid against.
+	bool getFirstObjectHitByRaySorted(const EnemyStorage& storage, const Vector& originPoint, const Vector& endPoint, GameObject*& p_obj)
+	{
+		std::vector<GameObject*> objects;
+		objects.insert(objects.end(), storage.begin(), storage.end());
+		std::sort(objects.begin(), objects.end(), [&originPoint](GameObject* obj1, GameObject* obj2) -> bool {
+			float dist1 = (obj1->getPos2D() - originPoint).sqrLength();
+			float dist2 = (obj2->getPos2D() - originPoint).sqrLength();
+			return dist1 < dist2;
+		});
+
+		Line ray(originPoint, endPoint);
+		for (GameObject* obj : objects) {
+			if (isObjectHitByRay(ray, obj)) {
+				p_obj = obj;
+				return true;
+			}
+		}
+		p_obj = nullptr;
+		return false;
+	}
+
+	// Eye::percept before projectBatch: two projections onto the view line, their lengths,
+	// then the signs from which side of the lines the enemy is on. Kept to check the paths against.
+	Vector perceptLikeEye(const Vector& posVector, const Vector& rotationVector, const Vector& vectorToProject)
+	{
+		Vector lineVector{ -rotationVector.y, rotationVector.x };
+		float lineVectorLength = returnVectorLength(lineVector);
+		Vector projectedVector = posVector + lineVector * ((lineVector * (vectorToProject - posVector)) / (lineVectorLength * lineVectorLength));
+		Vector projectedEnemyX = projectedVector - posVector;
+		Vector projectedEnemyY = vectorToProject - projectedVector;
+
+		Vector percepted{ returnVectorLength(projectedEnemyX), returnVectorLength(projectedEnemyY) };
+		Vector toEnemy = vectorToProject - posVector;
+		if (toEnemy.x * lineVector.y - toEnemy.y * lineVector.x < 0)
+			percepted.y *= -1;
+		if (toEnemy.x * rotationVector.y - toEnemy.y * rotationVector.x < 0)
+			percepted.x *= -1;
+		return percepted;
+	}
+
+	struct BenchmarkResult {
+		double nsPerCall;
+		double allocationsPerCall;
+		int hits;
+	};
+
+	// Runs body(i) iterations times and reports the time and heap allocations per call
+	template<typename Body>
+	BenchmarkResult measure(int iterations, Body body)
+	{
+		int hits = 0;
+		const size_t allocationsBefore = getAllocationCount();
+		auto startTime = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < iterations; i++)
+			hits += body(i) ? 1 : 0;
+
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - startTime;
+		const size_t allocations = getAllocationCount() - allocationsBefore;
+
+		return { elapsed.count() / iterations, double(allocations) / iterations, hits };
+	}
+
+	void printResult(const char* name, const BenchmarkResult& result)
+	{
+		std::cout << name << ": " << result.nsPerCall << " ns/call, "
+			<< result.allocationsPerCall << " allocations/call, " << result.hits << " hits\n";
+	}
+
+	// the allocation numbers are all 0 without the counting operator new
+	void noteAllocationCounting()
+	{
+		if constexpr (!isCountingAllocations)
+			std::cout << "allocations are not counted in this build, see alloc_counter.h\n";
+	}
+
+	struct PhaseTotals {
+		double nanoseconds = 0.0;
+		size_t allocations = 0;
+	};
+
+	// Runs body() once and adds its time and heap allocations to totals
+	template<typename Body>
+	void addPhase(PhaseTotals& totals, Body body)
+	{
+		const size_t allocationsBefore = getAllocationCount();
+		auto startTime = std::chrono::steady_clock::now();
+
+		body();
+
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - startTime;
+		totals.nanoseconds += elapsed.count();
+		totals.allocations += getAllocationCount() - allocationsBefore;
+	}
+
+}
+
+int runGeometryBenchmark(int iterations)
+{
+	if (iterations <= 0)
+		iterations = 100000;
+
+	std::mt19937 rng(2019);
+	std::uniform_real_distribution<float> field(-benchmarkFieldSize / 2, benchmarkFieldSize / 2);
+
+	// spawning schedules detection against the player
+	player target({ 0.0f, 0.0f });
+	playerList.push_back(&target);
+
+	Line rays[benchmarkRayCount];
+	for (int i = 0; i < benchmarkRayCount; i++) {
+		Vector origin{ field(rng), field(rng) };
+		rays[i] = Line(origin, origin + Vector{ field(rng), field(rng) } / 2.f);
+	}
+
+	std::cout << "geometry benchmark, " << iterations << " iterations\n";
+	noteAllocationCounting();
+
+	bool isGridAllocationFree = true;
+	int mismatches = 0;
+	for (int enemyCount : geometryEnemyCounts) {
+		EnemyStorage storage;
+		for (int i = 0; i < enemyCount; i++) {
+			enemy* enemyInst = new enemy({ field(rng), field(rng) }, circleFlag, enemyType::EASY);
+			enemyInst->spawnInto(storage);
+		}
+
+		BenchmarkResult grid = measure(iterations, [&](int i) {
+			GameObject* hit = nullptr;
+			const Line& ray = rays[i % benchmarkRayCount];
+			return enemyGrid.getFirstObjectHitByRay(ray.getP1(), ray.getP2(), hit);
+		});
+
+		// every ray once, the sort makes more than that slow at 10k
+		BenchmarkResult sorted = measure(benchmarkRayCount, [&](int i) {
+			GameObject* hit = nullptr;
+			const Line& ray = rays[i];
+			return getFirstObjectHitByRaySorted(storage, ray.getP1(), ray.getP2(), hit);
+		});
+
+		for (const Line& ray : rays) {
+			GameObject* gridHit = nullptr;
+			GameObject* sortedHit = nullptr;
+			enemyGrid.getFirstObjectHitByRay(ray.getP1(), ray.getP2(), gridHit);
+			getFirstObjectHitByRaySorted(storage, ray.getP1(), ray.getP2(), sortedHit);
+			if (gridHit != sortedHit)
+				mismatches++;
+		}
+
+		std::cout << enemyCount << " enemies\n";
+		printResult("  grid ray query", grid);
+		printResult("  sorted ray query", sorted);
+		isGridAllocationFree = isGridAllocationFree && grid.allocationsPerCall == 0;
+
+		for (enemy* enemyInst : storage) {
+			enemyGrid.remove(enemyInst);
+			delete enemyInst;
+		}
+	}
+
+	BenchmarkResult polygon = measure(iterations, [&](int i) {
+		const Line& ray = rays[i % benchmarkRayCount];
+		return isObjectHitByRay(Line(ray.getP1() / 4.f, ray.getP2() / 4.f), &target);
+	});
+
+	BenchmarkResult intersection = measure(iterations, [&](int i) {
+		Vector intersectingPoint;
+		const Line& line1 = rays[i % benchmarkRayCount];
+		const Line& line2 = rays[(i + 1) % benchmarkRayCount];
+		return get_Intersect_Point_From_2_Lines(line1, line2, intersectingPoint);
+	});
+
+	printResult("polygon ray test", polygon);
+	printResult("line intersection", intersection);
+	std::cout << mismatches << " rays where the grid and the sorted query hit different enemies\n";
+
+	const size_t projectedCount = size_t(geometryEnemyCounts[std::size(geometryEnemyCounts) - 1]);
+	std::vector<float> posX(projectedCount), posY(projectedCount);
+	std::vector<float> outX(projectedCount), outY(projectedCount);
+	std::vector<Vector> percepted(projectedCount);
+	const Vector eyePos{ field(rng), field(rng) };
+	const Vector eyeRotation = Vector{ field(rng), field(rng) } / 10.f;
+	for (size_t i = 0; i < projectedCount; i++) {
+		posX[i] = field(rng);
+		posY[i] = field(rng);
+		percepted[i] = perceptLikeEye(eyePos, eyeRotation, { posX[i], posY[i] });
+	}
+
+	bool isProjectionExact = true;
+	for (projectionPath path : { projectionPath::SCALAR, projectionPath::SSE, projectionPath::AVX2 }) {
+		if (path > getProjectionPath()) {
+			std::cout << getProjectionPathName(path) << " projection: not supported on this CPU\n";
+			continue;
+		}
+
+		BenchmarkResult projection = measure(iterations / 100 + 1, [&](int) {
+			projectBatch(path, posX.data(), posY.data(), projectedCount, eyePos.x, eyePos.y,
+				eyeRotation.x, eyeRotation.y, outX.data(), outY.data());
+			return true;
+		});
+
+		float worstError = 0.0f;
+		for (size_t i = 0; i < projectedCount; i++) {
+			const float distance = std::max(returnVectorLength(percepted[i]), 1.0f);
+			const float error = std::max(std::abs(outX[i] - percepted[i].x), std::abs(outY[i] - percepted[i].y)) / distance;
+			worstError = std::max(worstError, error);
+		}
+		isProjectionExact = isProjectionExact && worstError <= projectionTolerance;
+
+		std::cout << getProjectionPathName(path) << " projection: " << projection.nsPerCall / projectedCount
+			<< " ns/enemy, worst error against Eye::percept " << worstError << "\n";
+	}
+
+	playerList.clear();
+	simulation.clear();
+
+	const bool allocationFree = isGridAllocationFree && polygon.allocationsPerCall == 0 &&
+		intersection.allocationsPerCall == 0;
+	return (allocationFree && mismatches == 0 && isProjectionExact) ? 0 : 1;
+}
+
+int runStateSoak(int cycles)
+{
+	if (cycles <= 0)
+		cycles = 10000;
+	noteAllocationCounting();
+
+	auto cycle = [] {
+		newGame.toState(gameState::MAINMENU);
+		newGame.setup();
+		newGame.pushState(gameState::CREDIT);
+		newGame.setup();
+		newGame.popState();
+		newGame.setup();
+		newGame.toState(gameState::GAMEPLAY);
+		newGame.setup();
+	};
+
+	// the first round builds every state and loads what they keep
+	cycle();
+	const size_t liveBefore = getLiveAllocationCount();
+
+	auto startTime = std::chrono::steady_clock::now();
+	for (int i = 1; i < cycles; i++)
+		cycle();
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - startTime;
+
+	const size_t liveAfter = getLiveAllocationCount();
+
+	std::cout << "state soak, " << cycles << " cycles, " << elapsed.count() / cycles << " us/cycle, live allocations "
+		<< liveBefore << " -> " << liveAfter << "\n";
+	return (liveAfter > liveBefore) ? 1 : 0;
+}
+
+int runHeadlessGame(int frames, const char* recordPath)
+{
+	if (frames <= 0)
+		frames = 3600;
+
+	const bool isRasterizing = recordPath != nullptr && std::string(recordPath).find(".png") != std::string::npos;
+	std::ofstream recordFile;
+	if (recordPath != nullptr && !isRasterizing) {
+		recordFile.open(recordPath);
+		if (!recordFile) {
+			std::cout << "could not open " << recordPath << "\n";
+			return 1;
+		}
+	}
+	NullRenderer nullRenderer;
+	RecordingRenderer recordingRenderer(recordPath != nullptr ? &recordFile : nullptr);
+	std::unique_ptr<SoftwareRenderer> softwareRenderer;
+	renderer = (recordPath != nullptr) ? static_cast<Renderer*>(&recordingRenderer) : &nullRenderer;
+	if (isRasterizing) {
+		softwareRenderer = std::make_unique<SoftwareRenderer>(headlessWindowSize, headlessWindowSize);
+		softwareRenderer->setBackground(defaultFillColor);
+		renderer = softwareRenderer.get();
+	}
+
+	// what update_window() would have set
+	framePacer.setDeltaTime(headlessFrameTime);
+	Width = headlessWindowSize;
+	Height = headlessWindowSize;
+	WindowIsFocused = true; // GamePlay holds the world still otherwise
+
+	newGame.toState(gameState::GAMEPLAY);
+
+	int restarts = 0;
+	auto startTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; i++) {
+		newGame.setup();
+		renderer->beginFrame();
+		newGame.update();
+		renderer->endFrame();
+
+		// nobody is pressing anything, so instead of the game over screen just play again
+		if (simulation.isPlayerDead()) {
+			newGame.toState(gameState::GAMEPLAY);
+			restarts++;
+		}
+	}
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - startTime;
+
+	std::cout << "headless game, " << frames << " frames, " << elapsed.count() / frames << " us/frame, "
+		<< restarts << " restarts\n";
+	if (isRasterizing)
+		softwareRenderer->getImage().SaveToPNG(recordPath);
+	else if (recordPath != nullptr) {
+		for (int kind = 0; kind < int(renderCommandKind::COUNT); kind++)
+			std::cout << getRenderCommandName(renderCommandKind(kind)) << " "
+				<< double(recordingRenderer.getCommandCount(renderCommandKind(kind))) / frames << "/frame\n";
+	}
+
+	renderer = &doodleRenderer;
+	return 0;
+}
+
+int runRasterizerBenchmark(int frames, const char* pngPath)
+{
+	if (frames <= 0)
+		frames = 20;
+
+	struct Resolution {
+		int width;
+		int height;
+	};
+	const Resolution resolutions[] = { { headlessWindowSize, headlessWindowSize }, { 3840, 2160 } };
+
+	std::cout << "rasterizer benchmark, " << frames << " frames, " << rasterEnemyCount << " ellipses, "
+		<< rasterLineCount << " lines, " << rasterQuadCount * 3 << " polygons\n";
+	for (const Resolution& resolution : resolutions) {
+		for (unsigned int threads : { 1u, 0u }) {
+			SoftwareRenderer target(resolution.width, resolution.height, threads);
+			target.setBackground(defaultFillColor);
+			drawRasterScene(target, resolution.width, resolution.height);  // warms up the tile lists
+
+			auto startTime = std::chrono::steady_clock::now();
+			for (int i = 0; i < frames; i++)
+				drawRasterScene(target, resolution.width, resolution.height);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+
+			const double msPerFrame = elapsed.count() / frames;
+			std::cout << resolution.width << "x" << resolution.height << ", " << target.getThreadCount() << " threads: "
+				<< msPerFrame << " ms/frame, " << resolution.width * double(resolution.height) / msPerFrame / 1000.0 << " Mpixel/s\n";
+
+			if (pngPath != nullptr && threads == 0 && resolution.width == headlessWindowSize)
+				target.getImage().SaveToPNG(pngPath);
+		}
+	}
+	return 0;
+}
+
+int runHrtfBenchmark(int voices)
+{
+	if (voices <= 0)
+		voices = hrtfRealTimeVoices;
+
+	const unsigned int sampleRate = SoftwareMixer::outputRate;
+	const size_t blockFrames = SoftwareMixer::blockFrames;
+
+	HrtfSet hrtf;
+	const bool isMeasured = hrtf.load(SoftwareMixer::hrtfDataPath, sampleRate);
+	if (!isMeasured)
+		hrtf.makeSphericalHead(sampleRate);
+	BinauralRenderer renderer(hrtf);
+
+	std::mt19937 rng(2019);
+	std::uniform_real_distribution<float> noise(-1.f, 1.f);
+	std::vector<float> input(blockFrames * 16);
+	for (float& sample : input)
+		sample = noise(rng);
+	std::vector<float> output(blockFrames * 2);
+
+	std::vector<BinauralVoice> binauralVoices(static_cast<size_t>(voices));
+	for (BinauralVoice& voice : binauralVoices)
+		voice.reset();
+
+	// every voice turns a full circle every few seconds, like the turret spinning
+	const int blocks = int(hrtfBenchmarkSeconds * sampleRate / blockFrames);
+	auto startTime = std::chrono::steady_clock::now();
+	for (int block = 0; block < blocks; block++) {
+		std::fill(output.begin(), output.end(), 0.f);
+		for (int v = 0; v < voices; v++) {
+			const float azimuth = float((block * 7 + v * 37) % 360);
+			const float* dry = input.data() + size_t((block + v) % 16) * blockFrames;
+			renderer.render(binauralVoices[size_t(v)], dry, blockFrames, azimuth, output.data());
+		}
+	}
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - startTime;
+
+	const double usPerVoiceBlock = elapsed.count() / (double(blocks) * voices);
+	const double usPerBlock = double(blockFrames) * 1000000.0 / sampleRate;
+	const int voicesPerCore = int(usPerBlock / usPerVoiceBlock);
+
+	std::cout << "hrtf benchmark, " << voices << " voices, " << hrtfBenchmarkSeconds << " s of audio, "
+		<< (isMeasured ? "measured" : "spherical head") << " hrtf, " << usPerVoiceBlock << " us/voice block, "
+		<< voicesPerCore << " voices per core\n";
+	return (voicesPerCore < hrtfRealTimeVoices) ? 1 : 0;
+}
+
+int runStressBenchmark(int ticks, const char* jsonPath)
+{
+	if (ticks <= 0)
+		ticks = stressDefaultTicks;
+	if (jsonPath == nullptr)
+		jsonPath = "stress.json";
+	noteAllocationCounting();
+
+	std::ofstream json(jsonPath);
+	if (!json) {
+		std::cout << "could not open " << jsonPath << "\n";
+		return 1;
+	}
+
+	// the voice manager lets go of voices that have nothing to play, so the blinks get a quiet second
+	const std::vector<sf::Int16> silence(stressSoundRate, 0);
+	soundCache.insertDecoded(stressSoundPath, silence.data(), silence.size(), 1, stressSoundRate);
+	const SoundHandle blinkSound = soundCache.acquire(stressSoundPath);
+
+	json << "{\n  \"ticks\": " << ticks << ",\n  \"runs\": [";
+
+	std::vector<SpawnRecord> spawns;
+	bool isFirstRun = true;
+	simulation.setSeed(2019); // the same waves every run
+	for (size_t enemyCount : stressEnemyCounts) {
+		// every enemyType from every direction, all coming out on the first tick
+		spawns.resize(enemyCount);
+		for (size_t i = 0; i < enemyCount; i++) {
+			spawns[i].direction = uint8_t(1 + i % int(directionType::RIGHT));
+			spawns[i].type = uint8_t(1 + (i / int(directionType::RIGHT)) % int(enemyType::SUPER_FAST));
+			spawns[i].reserved = 0;
+			spawns[i].startTime = 0.0f;
+		}
+		simulation.setupWave(spawns.data(), spawns.size());
+
+		// the player of setupWave() has no modules, these run here so each gets its own time
+		Eye eye;
+		Ear ear;
+		eye.link(playerList[0]);
+		ear.link(playerList[0]);
+
+		PhaseTotals emergence;
+		addPhase(emergence, [] { simulation.advance(simulationDeltaTime); });
+
+		PhaseTotals phases[int(stressPhase::COUNT)];
+		int hits = 0;
+		for (int tick = 0; tick < ticks; tick++) {
+			addPhase(phases[int(stressPhase::UPDATE)], [] { simulation.advance(simulationDeltaTime); });
+
+			addPhase(phases[int(stressPhase::PERCEPTION)], [&] { eye.percept(); });
+
+			addPhase(phases[int(stressPhase::RAY_QUERY)], [&] {
+				const Vector origin = playerList[0]->getPos2D();
+				for (int ray = 0; ray < stressRaysPerTick; ray++) {
+					const float angle = TWO_PI * ray / stressRaysPerTick + tick * 0.01f;
+					GameObject* hit = nullptr;
+					if (getFirstObjectHitByRay(origin, origin + Vector{ cosf(angle), sinf(angle) } * maxCannonRange, hit))
+						hits++;
+				}
+			});
+
+			addPhase(phases[int(stressPhase::AUDIO)], [&] {
+				for (const SoundEvent& event : simulation.getSoundEvents()) {
+					if (event.type == soundEventType::ENEMY_BLINK)
+						voiceManager.playEnemy(event.enemyHandle, event.wave, blinkSound, voiceCategory::ENEMY_BLINK, 0, false);
+				}
+				ear.percept();
+				voiceManager.update(simulationDeltaTime);
+			});
+		}
+
+		const size_t peakResidentBytes = getPeakResidentBytes();
+		voiceManager.stopAll();
+		simulation.clear();
+
+		PhaseTotals total;
+		for (const PhaseTotals& phase : phases) {
+			total.nanoseconds += phase.nanoseconds;
+			total.allocations += phase.allocations;
+		}
+
+		std::cout << "stress, " << enemyCount << " enemies, " << ticks << " ticks: " << total.nanoseconds / ticks << " ns/tick, "
+			<< double(total.allocations) / ticks << " allocations/tick, peak RSS " << peakResidentBytes / (1024 * 1024) << " MB, "
+			<< emergence.nanoseconds / enemyCount << " ns/emergence, " << hits << " ray hits\n";
+		for (int phase = 0; phase < int(stressPhase::COUNT); phase++)
+			std::cout << "  " << stressPhaseNames[phase] << ": " << phases[phase].nanoseconds / ticks << " ns/tick, "
+				<< double(phases[phase].allocations) / ticks << " allocations/tick\n";
+
+		json << (isFirstRun ? "\n" : ",\n") << "    {\n"
+			<< "      \"enemies\": " << enemyCount << ",\n"
+			<< "      \"nsPerTick\": " << total.nanoseconds / ticks << ",\n"
+			<< "      \"allocationsPerTick\": " << double(total.allocations) / ticks << ",\n"
+			<< "      \"peakResidentBytes\": " << peakResidentBytes << ",\n"
+			<< "      \"emergence\": { \"nsPerEnemy\": " << emergence.nanoseconds / enemyCount
+			<< ", \"allocationsPerEnemy\": " << double(emergence.allocations) / enemyCount << " },\n"
+			<< "      \"phases\": {";
+		for (int phase = 0; phase < int(stressPhase::COUNT); phase++)
+			json << ((phase == 0) ? "\n" : ",\n") << "        \"" << stressPhaseNames[phase] << "\": { \"nsPerTick\": "
+				<< phases[phase].nanoseconds / ticks << ", \"allocationsPerTick\": " << double(phases[phase].allocations) / ticks << " }";
+		json << "\n      }\n    }";
+		isFirstRun = false;
+	}
+
+	json << "\n  ]\n}\n";
+
+	soundCache.release(blinkSound);
+	std::cout << "results written to " << jsonPath << "\n";
+	return 0;
+}
@@ -0,0 +1,46 @@
+﻿/*
+  benchmark.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+
+
+// Times the cannon ray query at 100, 1k and 10k enemies against the sorted search it
+// replaced, and the line intersection paths, counting the heap allocations they make.
+// Fails if the two ray queries disagree on any ray, or if a projectBatch path strays
+// from the old Eye::percept math by more than 2e-6 of the distance. Runs without a window, see main().
+int runGeometryBenchmark(int iterations);
+
+// Goes menu -> play -> menu (and through the pushed pages) cycles times and fails if
+// the live heap allocations grew after the first round. Needs the window, see main().
+int runStateSoak(int cycles);
+
+// Runs GamePlay frames at 60 Hz without a window, drawing to the null renderer or, with
+// a path, recording every frame's commands into that file and printing their counts.
+// A .png path rasterizes on the CPU instead and saves the last frame there.
+int runHeadlessGame(int frames, const char* recordPath);
+
+// Rasterizes a busy synthetic frame in software at 820x820 and 3840x2160, on one
+// thread and on every core, and prints the frame times. Saves the 820x820 frame
+// when given a path.
+int runRasterizerBenchmark(int frames, const char* pngPath);
+
+// Spawns synthetic waves of 100 up to 100000 enemies of every type and steps them headless
+// for ticks ticks, timing the simulation update, the eye's projection, cannon ray queries
+// and the enemy voice updates apart. Prints a summary and writes the numbers as JSON to
+// jsonPath (stress.json by default).
+int runStressBenchmark(int ticks, const char* jsonPath);
+
+// Renders voices through the HRTF convolution with the directions sweeping around and
+// reports how many fit in one core in real time. Fails under 64, see main().
+int runHrtfBenchmark(int voices);
@@ -18,11 +18,42 @@ using namespace doodle;
 
 #include "variables.h"
 #include "player.h"
+#include "pool_allocator.h"
+#include "profiler.h"
 
 
 
-enemy::enemy(const Vector& newPos2D, player* playerPtr, int nEdges, enemyType type, float cameoutTime)
-	:GameObject(newPos2D, nEdges, red5),type(type),targetPlayer(playerPtr), soundIndex(int(enemyType::MODERATE)), emergenceTime(cameoutTime), detectionCount(5.0f)
+namespace {
+	PoolAllocator<enemy>& enemyPool()
+	{
+		static PoolAllocator<enemy> pool;
+		return pool;
+	}
+}
+
+void* enemy::operator new(size_t size)
+{
+	if (size != sizeof(enemy))
+		return ::operator new(size);
+	return enemyPool().allocate();
+}
+
+void enemy::operator delete(void* ptr, size_t size)
+{
+	if (size != sizeof(enemy)) {
+		::operator delete(ptr);
+		return;
+	}
+	enemyPool().deallocate(ptr);
+}
+
+size_t enemy::getPooledCount()
+{
+	return enemyPool().getBlocksInUse();
+}
+
+enemy::enemy(const Vector& newPos2D, int nEdges, enemyType type)
+	:GameObject(newPos2D, nEdges, red5),type(type), soundIndex(int(enemyType::MODERATE))
 {
 	int maxRand = 0;
 	switch (type) // set properties according to its 'enemyType'
@@ -72,90 +103,176 @@ enemy::enemy(const Vector& newPos2D, player* playerPtr, int nEdges, enemyType ty
 			color = blue3;
 			wheelSpeed = 20;
 			soundIndex = int(enemyType::SUPER_FAST);
-			sound.setLoop(true);
 			break;
 		default:
 			break;
 	}
-	uniqueBlinkSpeedModifier = (std::rand() % maxRand);
-
-	sound.setMinDistance(500.0f); sound.setAttenuation(0.3f);
+	uniqueBlinkSpeedModifier = gameplayRandom.nextInt(0, maxRand);
 
 	pos2DProjected = { 2000.f, 2000.f };
 };
 
-void enemy::update()
+void enemy::spawnInto(EnemyStorage& newStorage)
 {
+	unsigned char initFlags = enemyFlag::detected;
+	if (type == enemyType::ZIGZAG)
+		initFlags |= enemyFlag::zigzag;
+	if (type == enemyType::WARP)
+		initFlags |= enemyFlag::warp;
 
-	if (!isDying) {
-		for (player* player : playerList)
-		{
-			float dist_To_Player = (player->getPos2D() - pos2D).length();
-			if (dist_To_Player <= playerDrawSize / 2.f + enemyDrawSize / 2.f)
-			{
-				isDying = true;
-				this->onHit();
-				player->onHit();
-				return;
-			}
-		}
+	storage = &newStorage;
+	handle = storage->insert(this, pos2D, wheelSpeed, 50.0f * (fadeSpeed + uniqueBlinkSpeedModifier), initFlags, simulation.getTime());
 
-		//for zigzag enemy
-		if (directionChangeDelay > 0)
-			directionChangeDelay--;
-		else
-		{
-			directionChangeDelay = initDirectionChangeDelay;
-			directionFlag = !directionFlag;
-		}
+	enemyGrid.insert(this, pos2D);
 
-		//for warp enemy
-		warpTimer++;
-		if (warpTimer == maxWarpTimer && type == enemyType::WARP)
-		{
-			warp();
-			warpTimer = 0;
-		}
+	// comes out already detected, so it blinks right away
+	simulation.schedule(0.0f, scheduledEventType::BLINK, handle);
+	scheduleDetection(*storage, row());
+	if (initFlags & enemyFlag::zigzag)
+		simulation.schedule(initDirectionChangeDelay, scheduledEventType::ZIGZAG_FLIP, handle);
+	if (initFlags & enemyFlag::warp)
+		simulation.schedule(maxWarpTime, scheduledEventType::WARP, handle);
+}
 
-		move();
-		acceleration = Vector{ 0.f,0.f };
-		speed = lerp(speed, { 0.f,0.f }, coreDeceleration);
+Vector enemy::getPos2D() const
+{
+	if (storage == nullptr) // not came out yet
+		return pos2D;
+	return storage->getPos2D(row());
+}
 
+Vector enemy::getPos2DProjected() const
+{
+	if (storage == nullptr)
+		return pos2DProjected;
+	return storage->getPos2DProjected(row());
+}
 
+void enemy::updateAll(EnemyStorage& storage)
+{
+	PROFILE_SCOPE("enemy::updateAll");
 
-		Vector targetVector = targetPlayer->getPos2D();
+	const size_t count = storage.size();
+	if (count == 0 || playerList.empty())
+		return;
 
-		detectionCounter += globalDeltaTime * (2000 / sqrt((targetVector.x - pos2D.x) * (targetVector.x - pos2D.x) + (targetVector.y - pos2D.y) * (targetVector.y - pos2D.y)));
+	float* posX = storage.posX.data();
+	float* posY = storage.posY.data();
+	unsigned char* flags = storage.flags.data();
 
-		if (detectionCounter > detectionCount) { // For the Blinking & sound emit thing
-			detectionCounter = 0;
-			detected = true;
-		}
+	const float hitDistance = playerDrawSize / 2.f + enemyDrawSize / 2.f;
+	for (player* player : playerList)
+	{
+		const Vector playerPos = player->getPos2D();
+		for (size_t i = 0; i < count; i++)
+		{
+			if (flags[i] & (enemyFlag::dying | enemyFlag::dead))
+				continue;
 
-		if (alpha > 0) {
-			color.rgba &= ~alphaMask;
-			color.rgba |= unsigned int(alpha);
-			alpha -= 50.0f * (fadeSpeed + uniqueBlinkSpeedModifier) * globalDeltaTime;
-			if (alpha < 0)
-				alpha = 0;
-		}
-		else {
-			if (detected) {
-				alpha = float(alphaMask);
-				sound.setBuffer(SoundBuffers[audioIndex()]);
-				sound.play();
-				detected = false;
+			float dx = playerPos.x - posX[i];
+			float dy = playerPos.y - posY[i];
+			if (dx * dx + dy * dy <= hitDistance * hitDistance)
+			{
+				enemy* instEnemy = storage[i];
+				instEnemy->isDying = true;
+				flags[i] |= enemyFlag::dying;
+				instEnemy->onHit();
+				player->onHit();
 			}
 		}
 	}
-		else {
-			if (whenIsDie < ElapsedTime) {
-				this->onHit();
-				return;
-			}
+
+	moveAll(storage);
+}
+
+// Detection grows faster the closer the enemy is to the player. Instead of adding to the
+// counter every tick, it is brought up to date (trapezoid over the distance sampled at
+// both ends) whenever this event fires, and the next one is put where the counter should
+// cross detectionCount, but never more than maxDetectionLookahead away.
+void enemy::scheduleDetection(EnemyStorage& storage, size_t row)
+{
+	const Vector targetVector = playerList[0]->getPos2D();
+	const float now = simulation.getTime();
+
+	float dx = targetVector.x - storage.posX[row];
+	float dy = targetVector.y - storage.posY[row];
+	const float rate = 2000 / sqrtf(dx * dx + dy * dy);
+
+	storage.detectionCounter[row] += (now - storage.detectionSampleTime[row]) * (storage.detectionRate[row] + rate) / 2;
+	storage.detectionRate[row] = rate;
+	storage.detectionSampleTime[row] = now;
+
+	unsigned char& flags = storage.flags[row];
+	if (storage.detectionCounter[row] > detectionCount) { // For the Blinking & sound emit thing
+		storage.detectionCounter[row] = 0;
+		if (!(flags & enemyFlag::detected)) {
+			flags |= enemyFlag::detected;
+			// the blink waits for the previous one to fade out
+			const float fadeEnd = storage.getFadeEndTime(row);
+			simulation.schedule((fadeEnd > now) ? fadeEnd - now : 0.0f, scheduledEventType::BLINK, storage.handleAt(row));
 		}
-		(isProjectionOverlayed) ? (draw()) : (show());
+	}
 
+	float untilDetected = (detectionCount - storage.detectionCounter[row]) / rate;
+	if (untilDetected > maxDetectionLookahead)
+		untilDetected = maxDetectionLookahead;
+	simulation.schedule(untilDetected, scheduledEventType::DETECTION_CHECK, storage.handleAt(row));
+}
+
+void enemy::runScheduledEvent(EnemyStorage& storage, const ScheduledEvent& event)
+{
+	if (!storage.contains(event.enemyHandle))
+		return; // died since it was scheduled
+
+	const size_t row = storage.rowOf(event.enemyHandle);
+	unsigned char& flags = storage.flags[row];
+	if (flags & enemyFlag::dead)
+		return;
+	if ((flags & enemyFlag::dying) && event.type != scheduledEventType::DIE)
+		return;
+
+	switch (event.type) {
+	case scheduledEventType::DETECTION_CHECK:
+		scheduleDetection(storage, row);
+		break;
+	case scheduledEventType::BLINK:
+		storage.blinkTime[row] = simulation.getTime();
+		flags &= ~enemyFlag::detected;
+		simulation.queueSound(SoundEvent{ soundEventType::ENEMY_BLINK, gameWave, event.enemyHandle });
+		break;
+	case scheduledEventType::WARP: {
+		const Vector targetPos = playerList[0]->getPos2D();
+		const Vector oldPos = storage.getPos2D(row);
+		const Vector pos = oldPos + (targetPos - oldPos).getUnitVec() * warpDistance;
+		storage.posX[row] = pos.x;
+		storage.posY[row] = pos.y;
+		enemyGrid.move(storage[row], oldPos, pos);
+
+		storage.warpStartTime[row] = simulation.getTime();
+		simulation.schedule(maxWarpTime, scheduledEventType::WARP, event.enemyHandle);
+		break;
+	}
+	case scheduledEventType::ZIGZAG_FLIP:
+		flags ^= enemyFlag::directionFlag;
+		simulation.schedule(initDirectionChangeDelay, scheduledEventType::ZIGZAG_FLIP, event.enemyHandle);
+		break;
+	case scheduledEventType::DIE:
+		storage[row]->onHit();
+		break;
+	default:
+		break;
+	}
+}
+
+void enemy::update()
+{
+	// nothing polls per tick anymore, see runScheduledEvent()
+}
+
+void enemy::playBlinkSound(float delay)
+{
+	// SUPER_FAST keeps buzzing in between blinks
+	voiceManager.playEnemy(handle, gameWave, gameSounds[audioIndex()], voiceCategory::ENEMY_BLINK, int(type), type == enemyType::SUPER_FAST, delay);
 }
 
 
@@ -163,64 +280,70 @@ void enemy::update()
 
 void enemy::show()
 {
-	sound.setMinDistance(500.0f); sound.setAttenuation(0.3f);
-
-	push_settings();
+	const size_t index = row();
+	const Vector pos2DProjected = storage->getPos2DProjected(index, simulation.getInterpolation());
 
-	set_fill_color(color);
-	no_outline();
+	HexColor blinkColor = color;
+	blinkColor.rgba &= ~alphaMask;
+	blinkColor.rgba |= static_cast<unsigned int>(storage->getAlpha(index, simulation.getTime()));
 
 	//for warp enemy
 	float shakeX = 0.f;
 	float shakeY = 0.f;
 	if (type == enemyType::WARP)
 	{
-		shakeX = (float)warpTimer * random(-0.1f, 0.1f);
-		shakeY = (float)warpTimer * random(-0.1f, 0.1f);
+		float shake = (simulation.getTime() - storage->warpStartTime[index]) / maxWarpTime * maxWarpShake;
+		shakeX = shake * cosmeticRandom.nextFloat(-1.f, 1.f);
+		shakeY = shake * cosmeticRandom.nextFloat(-1.f, 1.f);
 	}
 	if(isDying)
 	{
-		set_outline_width(3.0f);
-		set_outline_color(HexColor{ 0xFFFFFFFF });
-		draw_line(pos2DProjected.x - enemyDrawSize /4, pos2DProjected.y - enemyDrawSize / 4, pos2DProjected.x + enemyDrawSize / 4, pos2DProjected.y + enemyDrawSize / 4);
-		draw_line(pos2DProjected.x + enemyDrawSize / 4, pos2DProjected.y - enemyDrawSize / 4, pos2DProjected.x - enemyDrawSize / 4, pos2DProjected.y + enemyDrawSize / 4);
+		const RenderState cross = RenderState().setOutline(HexColor{ 0xFFFFFFFF }, 3.0f);
+		renderQueue.drawLine(renderLayer::ENEMY, cross, pos2DProjected.x - enemyDrawSize /4, pos2DProjected.y - enemyDrawSize / 4, pos2DProjected.x + enemyDrawSize / 4, pos2DProjected.y + enemyDrawSize / 4);
+		renderQueue.drawLine(renderLayer::ENEMY, cross, pos2DProjected.x + enemyDrawSize / 4, pos2DProjected.y - enemyDrawSize / 4, pos2DProjected.x - enemyDrawSize / 4, pos2DProjected.y + enemyDrawSize / 4);
 	}
 	else
-		draw_ellipse((pos2DProjected.x + (float)shakeX) / showMultiplier, (pos2DProjected.y + (float)shakeY) / showMultiplier, enemyDrawSize, enemyDrawSize);
-
-	pop_settings();
+		renderQueue.drawEllipse(renderLayer::ENEMY, RenderState().setFill(blinkColor).noOutline(),
+			(pos2DProjected.x + (float)shakeX) / showMultiplier, (pos2DProjected.y + (float)shakeY) / showMultiplier, enemyDrawSize, enemyDrawSize);
 
 }
 void enemy::onHit()
 {
-		isDead = true;
-		auto it = find(enemyList[gameWave].begin(), enemyList[gameWave].end(), this);
-		enemyList[gameWave].erase(it);
-		delete this;
+	if (isDead)
+		return;
+
+	isDead = true;
+	storage->flags[row()] |= enemyFlag::dead;
+	enemyGrid.remove(this);
+
+	// GamePlay::update() is still walking enemyList, so the actual removal waits for the end of the frame
+	destroyedEnemyList.push_back(this);
 }
 
 void enemy::makeDying()
 {
-	sound.stop();
-	sound.setLoop(false);
-	sound.setBuffer(SoundBuffers[0]);
-	sound.play();
 	isDying = true;
-	whenIsDie = ElapsedTime + Dyingtime;
+	storage->flags[row()] |= enemyFlag::dying;
+	whenIsDie = simulation.getTime() + Dyingtime;
+	simulation.schedule(Dyingtime, scheduledEventType::DIE, handle);
+
+	simulation.queueSound(SoundEvent{ soundEventType::ENEMY_DYING, gameWave, handle });
 }
 
-void enemy::draw()
+void enemy::playDyingSound(float delay)
 {
-	sound.setMinDistance(100.0f); sound.setAttenuation(0.6f);
-
-	push_settings();
+	voiceManager.playEnemy(handle, gameWave, gameSounds[0], voiceCategory::ENEMY_DYING, int(type), false, delay);
+}
 
-	no_outline();
+void enemy::draw()
+{
+	const size_t index = row();
+	const Vector pos2DProjected = storage->getPos2DProjected(index, simulation.getInterpolation());
 
 	HexColor tempColor = color;
 
 	if (isDying)
-		tempColor = { random(0, 0xFFFFFF) };
+		tempColor = { cosmeticRandom.nextInt(0, 0xFFFFFF) };
 
 	int tempAlpha = 0;
 
@@ -230,11 +353,7 @@ void enemy::draw()
 	tempColor.rgba &= ~alphaMask;
 	tempColor.rgba |= unsigned int(tempAlpha);
 
-
-
-	set_fill_color(tempColor);
-
-
+	const RenderState state = RenderState().setFill(tempColor).noOutline();
 
 	float projectedSize = 0;
 	if (pos2DProjected.y > 0) { // 2.5D projected size	
@@ -249,48 +368,71 @@ void enemy::draw()
 	float shakeY = 0.f;
 	if (type == enemyType::WARP && !isDying)
 	{
-		shakeX = (float)warpTimer * random(-0.1f, 0.1f);
-		shakeY = (float)warpTimer * random(-0.1f, 0.1f);
+		float shake = (simulation.getTime() - storage->warpStartTime[index]) / maxWarpTime * maxWarpShake;
+		shakeX = shake * cosmeticRandom.nextFloat(-1.f, 1.f);
+		shakeY = shake * cosmeticRandom.nextFloat(-1.f, 1.f);
 	}
 
 
 	if (isDying) { // Display the crazy blinking when dying
 		float startDyingTime = (whenIsDie - Dyingtime);
-		float timeElapsed = ElapsedTime - startDyingTime;
-		float randomno = random(-5.f, 5.f);
-		draw_ellipse(((pos2DProjected.x + shakeX) * enemyDrawSize3DBase / pos2DProjected.y - randomno),
+		float timeElapsed = simulation.getTime() - startDyingTime;
+		float randomno = cosmeticRandom.nextFloat(-5.f, 5.f);
+		renderQueue.drawEllipse(renderLayer::ENEMY, state, ((pos2DProjected.x + shakeX) * enemyDrawSize3DBase / pos2DProjected.y - randomno),
 			shakeY, projectedSize * (Dyingtime - timeElapsed) / Dyingtime, projectedSize * (Dyingtime - timeElapsed) / Dyingtime);
 	}
 	else
-		draw_ellipse(((pos2DProjected.x + shakeX) * enemyDrawSize3DBase / pos2DProjected.y), shakeY, projectedSize, projectedSize);
-
-	pop_settings();
+		renderQueue.drawEllipse(renderLayer::ENEMY, state, ((pos2DProjected.x + shakeX) * enemyDrawSize3DBase / pos2DProjected.y), shakeY, projectedSize, projectedSize);
 
 }
-void enemy::move()
+void enemy::moveAll(EnemyStorage& storage)
 {
-	Vector moveDir = targetPlayer->getPos2D() - pos2D;
-	switch (type)
+	const size_t count = storage.size();
+
+	float* posX = storage.posX.data();
+	float* posY = storage.posY.data();
+	float* speedX = storage.speedX.data();
+	float* speedY = storage.speedY.data();
+	float* accelerationX = storage.accelerationX.data();
+	float* accelerationY = storage.accelerationY.data();
+	const float* wheelSpeed = storage.wheelSpeed.data();
+	unsigned char* flags = storage.flags.data();
+
+	const Vector targetPos = playerList[0]->getPos2D();
+
+	for (size_t i = 0; i < count; i++)
 	{
-	case enemyType::ZIGZAG:
-		if (directionFlag)
-			rotateVector(moveDir, QUARTER_PI*0.9f);
-		else
-			rotateVector(moveDir, -QUARTER_PI*0.9f);
-		break;
-	default:
-	break;
-	}
-	moveDir.toUnitVec();
-	acceleration = moveDir * wheelSpeed;
-	speed += acceleration; 
-	pos2D += speed * globalDeltaTime;
-}
+		if (flags[i] & (enemyFlag::dying | enemyFlag::dead))
+			continue;
 
-void enemy::warp()
-{
-	Vector warpDirection = (targetPlayer->getPos2D() - pos2D).getUnitVec();
-	pos2D += warpDirection * warpDistance;
+		const Vector oldPos{ posX[i], posY[i] };
+		Vector pos = oldPos;
+
+		//zigzag flips and warps are scheduled events
+		Vector moveDir = targetPos - pos;
+		if (flags[i] & enemyFlag::zigzag)
+		{
+			if (flags[i] & enemyFlag::directionFlag)
+				rotateVector(moveDir, QUARTER_PI*0.9f);
+			else
+				rotateVector(moveDir, -QUARTER_PI*0.9f);
+		}
+		moveDir.toUnitVec();
+
+		accelerationX[i] = moveDir.x * wheelSpeed[i];
+		accelerationY[i] = moveDir.y * wheelSpeed[i];
+		speedX[i] += accelerationX[i];
+		speedY[i] += accelerationY[i];
+		pos.x += speedX[i] * globalDeltaTime;
+		pos.y += speedY[i] * globalDeltaTime;
+
+		speedX[i] = lerp(speedX[i], 0.f, coreDeceleration);
+		speedY[i] = lerp(speedY[i], 0.f, coreDeceleration);
+
+		posX[i] = pos.x;
+		posY[i] = pos.y;
+		enemyGrid.move(storage[i], oldPos, pos);
+	}
 }
 
 Vector toVector(directionType type) // implicit direction indication to actual vector
@@ -298,16 +440,16 @@ Vector toVector(directionType type) // implicit direction indication to actual v
 	Vector newVector;
 	switch (type) {
 	case directionType::UP:
-		newVector = { float(random(-maxAxisDistance, maxAxisDistance)), float(random(maxAxisDistance * 3 / 4, maxAxisDistance)) };
+		newVector = { float(spawnRandom.nextInt(-maxAxisDistance, maxAxisDistance)), float(spawnRandom.nextInt(maxAxisDistance * 3 / 4, maxAxisDistance)) };
 		break;
 	case directionType::DOWN:
-		newVector = { float(random(-maxAxisDistance, maxAxisDistance)), float(random(-maxAxisDistance, -maxAxisDistance * 3 / 4)) };
+		newVector = { float(spawnRandom.nextInt(-maxAxisDistance, maxAxisDistance)), float(spawnRandom.nextInt(-maxAxisDistance, -maxAxisDistance * 3 / 4)) };
 		break;
 	case directionType::LEFT: 
-		newVector = { float(random(-maxAxisDistance, -maxAxisDistance * 3 / 4)), float(random(-maxAxisDistance, maxAxisDistance)) };
+		newVector = { float(spawnRandom.nextInt(-maxAxisDistance, -maxAxisDistance * 3 / 4)), float(spawnRandom.nextInt(-maxAxisDistance, maxAxisDistance)) };
 		break;
 	case directionType::RIGHT:
-		newVector = { float(random(-maxAxisDistance, maxAxisDistance * 3 / 4)), float(random(-maxAxisDistance, maxAxisDistance)) };
+		newVector = { float(spawnRandom.nextInt(-maxAxisDistance, maxAxisDistance * 3 / 4)), float(spawnRandom.nextInt(-maxAxisDistance, maxAxisDistance)) };
 		break;
 	}
 
@@ -16,6 +16,8 @@
 #include "game_object.h"
 #include "SFML/Audio.hpp"
 #include "variables.h"
+#include "enemy_storage.h"
+#include "event_scheduler.h"
 
 
 
@@ -45,11 +47,23 @@ enum class directionType {
 
 Vector toVector(directionType type);
 
+// Once spawned, the per frame state of an enemy (position, speed, alpha, timers...)
+// lives in the EnemyStorage of its wave; the object itself only keeps the cold part.
 class enemy : public GameObject
 {
 public:
 
-	enemy(const Vector& newPos2D, player* playerPtr, int nEdges, enemyType type, float cameoutTime);
+	enemy(const Vector& newPos2D, int nEdges, enemyType type);
+
+	// enemies come and go all game long, they live in a pool instead of on the heap
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+	static size_t getPooledCount();
+
+	// hot part of the update, streams through the arrays of every enemy in the storage
+	static void updateAll(EnemyStorage& storage);
+	static void moveAll(EnemyStorage& storage);
+	static void runScheduledEvent(EnemyStorage& storage, const ScheduledEvent& event);
 
 	void update() override;
 	void draw() override;
@@ -59,55 +73,50 @@ public:
 	bool getisDying() override {
 		return isDying;
 	}
-	void setEmergenceTime(const float curTime) {
-		emergenceTime += curTime;
-	}
-	
-	void move();
-	void noiseSpeed();
 
-	sf::Sound& audioSource() { return sound; };
+	Vector getPos2D() const override;
+	Vector getPos2DProjected() const override;
+
+	void spawnInto(EnemyStorage& newStorage);
+
+	// delay: how far into the frame it happened, for a backend that can start voices that exactly
+	void playBlinkSound(float delay);
+	void playDyingSound(float delay);
+
 	int audioIndex() { return soundIndex; };
 
-	float& getEmergenceTime() {
-		return emergenceTime;
-	}
 
-	void warp();
+	const SlotHandle& getHandle() const { return handle; }
+
 private: 
+	size_t row() const { return storage->rowOf(handle); }
+
 	enemyType type;
 
 	bool isDead = false;
-	bool detected = true;
 	bool isDying = false;
 
 	float whenIsDie = 0.0f;
 
 	//for zigzagmove
-	int initDirectionChangeDelay = 180;
-	int directionChangeDelay = initDirectionChangeDelay;
-	bool directionFlag = false;
+	static constexpr float initDirectionChangeDelay = 3.0f;
 
 	float wheelSpeed = 1.f;
-	const float warpDistance = 100.f;
-	Vector acceleration{ 0.f,0.f };
-	Vector speed{ 0.f,0.f };
-
-	float alpha = 0;
-
-	const player* targetPlayer = nullptr;
+	static constexpr float warpDistance = 100.f;
 
 	int uniqueBlinkSpeedModifier = 0;
 
-	const int maxWarpTimer = 300;
-	int warpTimer = 0;
+	static constexpr float maxWarpTime = 5.0f;
+	static constexpr float maxWarpShake = 30.0f;
 
-	sf::Sound sound;
 	int soundIndex = 0;
 
-	float detectionCounter = 0.0f;
-	float detectionCount = 5.0f;
+	static constexpr float detectionCount = 5.0f;
+	static constexpr float maxDetectionLookahead = 0.5f;
+
+	static void scheduleDetection(EnemyStorage& storage, size_t row);
 
-	float emergenceTime = 0.0f;
+	EnemyStorage* storage = nullptr;
+	SlotHandle handle;
 
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+﻿/*
+  enemy_storage.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "enemy_storage.h"
+
+
+
+template<typename Column>
+void EnemyStorage::forEachColumn(Column column)
+{
+	column(posX); column(posY);
+	column(projectedX); column(projectedY);
+	column(prevProjectedX); column(prevProjectedY);
+	column(speedX); column(speedY);
+	column(accelerationX); column(accelerationY);
+	column(detectionCounter);
+	column(detectionRate);
+	column(detectionSampleTime);
+	column(blinkTime);
+	column(warpStartTime);
+	column(wheelSpeed);
+	column(fadeRate);
+	column(flags);
+}
+
+SlotHandle EnemyStorage::insert(enemy* enemyPtr, const Vector& pos, float newWheelSpeed, float newFadeRate, unsigned char initFlags, float time)
+{
+	posX.push_back(pos.x);
+	posY.push_back(pos.y);
+	projectedX.push_back(2000.f); // far off screen until the Eye projects it
+	projectedY.push_back(2000.f);
+	prevProjectedX.push_back(2000.f);
+	prevProjectedY.push_back(2000.f);
+	speedX.push_back(0.f);
+	speedY.push_back(0.f);
+	accelerationX.push_back(0.f);
+	accelerationY.push_back(0.f);
+	detectionCounter.push_back(0.f);
+	detectionRate.push_back(0.f);
+	detectionSampleTime.push_back(time);
+	blinkTime.push_back(neverBlinked);
+	warpStartTime.push_back(time);
+	wheelSpeed.push_back(newWheelSpeed);
+	fadeRate.push_back(newFadeRate);
+	flags.push_back(initFlags);
+
+	return rows.insert(enemyPtr);
+}
+
+bool EnemyStorage::erase(const SlotHandle& handle)
+{
+	if (!rows.contains(handle))
+		return false;
+
+	// mirror the swap-with-last the slot map is about to do on its dense array
+	const size_t hole = rows.indexOf(handle);
+	const size_t last = rows.size() - 1;
+	forEachColumn([hole, last](auto& column) {
+		column[hole] = column[last];
+		column.pop_back();
+	});
+
+	return rows.erase(handle);
+}
+
+void EnemyStorage::clear()
+{
+	forEachColumn([](auto& column) { column.clear(); });
+	rows.clear();
+}
+
+void EnemyStorage::reserve(size_t count)
+{
+	forEachColumn([count](auto& column) { column.reserve(count); });
+	rows.reserve(count);
+}
@@ -0,0 +1,100 @@
+﻿/*
+  enemy_storage.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "basic_math.h"
+#include "slot_map.h"
+#include <vector>
+
+
+
+class enemy;
+
+constexpr float alphaMax = 255.f;
+constexpr float neverBlinked = -1.0e9f;
+
+// bits of EnemyStorage::flags
+namespace enemyFlag {
+	constexpr unsigned char dying = 1 << 0;
+	constexpr unsigned char dead = 1 << 1;
+	constexpr unsigned char detected = 1 << 2;
+	constexpr unsigned char directionFlag = 1 << 3;
+	constexpr unsigned char zigzag = 1 << 4;
+	constexpr unsigned char warp = 1 << 5;
+	constexpr unsigned char projected = 1 << 6; // has been through Eye::percept at least once
+}
+
+// Enemies of one wave, split by how often the data is touched.
+// The per frame fields live in parallel arrays indexed by the same dense row,
+// so the update, move and perception loops stream through memory.
+// The enemy object itself is the cold part (sound, type config, edges) and is
+// only reached for the rare events (blink sound, death, drawing).
+class EnemyStorage
+{
+public:
+	SlotHandle insert(enemy* enemyPtr, const Vector& pos, float wheelSpeed, float fadeRate, unsigned char initFlags, float time);
+	bool erase(const SlotHandle& handle);
+	void clear();
+	void reserve(size_t count);
+
+	bool contains(const SlotHandle& handle) const { return rows.contains(handle); }
+	size_t rowOf(const SlotHandle& handle) const { return rows.indexOf(handle); }
+	SlotHandle handleAt(size_t row) const { return rows.handleAt(row); }
+
+	size_t size() const { return rows.size(); }
+	bool empty() const { return rows.empty(); }
+
+	enemy* operator[](size_t row) const { return rows[row]; }
+	enemy* find(const SlotHandle& handle) const { return contains(handle) ? rows[rowOf(handle)] : nullptr; }
+
+	// range-for over the enemies themselves, like the old vector<enemy*>
+	std::vector<enemy*>::const_iterator begin() const { return rows.begin(); }
+	std::vector<enemy*>::const_iterator end() const { return rows.end(); }
+
+	// hot, every frame
+	std::vector<float> posX, posY;
+	std::vector<float> projectedX, projectedY;
+	std::vector<float> prevProjectedX, prevProjectedY; // as of the previous tick, for interpolation
+	std::vector<float> speedX, speedY;
+	std::vector<float> accelerationX, accelerationY;
+	std::vector<float> detectionCounter;
+
+	// touched only when one of the enemy's scheduled events fires
+	std::vector<float> detectionRate;       // counter growth per second when last sampled
+	std::vector<float> detectionSampleTime; // when the counter was last brought up to date
+	std::vector<float> blinkTime;           // the blink fades out from here at fadeRate
+	std::vector<float> warpStartTime;       // the next warp is maxWarpTime after this
+
+	// per enemy constants the hot loops need, copied out of the cold config on insert
+	std::vector<float> wheelSpeed;
+	std::vector<float> fadeRate;
+	std::vector<unsigned char> flags;
+
+	Vector getPos2D(size_t row) const { return Vector{ posX[row], posY[row] }; }
+	float getAlpha(size_t row, float time) const {
+		const float faded = (time - blinkTime[row]) * fadeRate[row];
+		return (faded >= alphaMax) ? 0.f : alphaMax - faded;
+	}
+	float getFadeEndTime(size_t row) const { return blinkTime[row] + alphaMax / fadeRate[row]; }
+	Vector getPos2DProjected(size_t row) const { return Vector{ projectedX[row], projectedY[row] }; }
+	Vector getPos2DProjected(size_t row, float interpolation) const {
+		return Vector{ lerp(prevProjectedX[row], projectedX[row], interpolation), lerp(prevProjectedY[row], projectedY[row], interpolation) };
+	}
+
+private:
+	template<typename Column>
+	void forEachColumn(Column column);
+
+	SlotMap<enemy*> rows;
+};
@@ -0,0 +1,57 @@
+﻿/*
+  event_scheduler.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "event_scheduler.h"
+#include <algorithm>
+
+
+
+namespace {
+	bool laterThan(const ScheduledEvent& a, const ScheduledEvent& b)
+	{
+		return a.tick > b.tick;
+	}
+}
+
+void EventScheduler::schedule(const ScheduledEvent& event)
+{
+	ScheduledEvent due = event;
+	if (due.tick < currentTick) // already late, fire on the next runDue
+		due.tick = currentTick;
+
+	if (due.tick - currentTick < wheelSize)
+		slots[due.tick & (wheelSize - 1)].push_back(due);
+	else {
+		overflow.push_back(due);
+		std::push_heap(overflow.begin(), overflow.end(), laterThan);
+	}
+	pendingCount++;
+}
+
+void EventScheduler::clear()
+{
+	for (std::vector<ScheduledEvent>& slot : slots)
+		slot.clear();
+	overflow.clear();
+	pendingCount = 0;
+}
+
+void EventScheduler::pullFromOverflow()
+{
+	while (!overflow.empty() && overflow.front().tick - currentTick < wheelSize) {
+		std::pop_heap(overflow.begin(), overflow.end(), laterThan);
+		const ScheduledEvent& event = overflow.back();
+		slots[event.tick & (wheelSize - 1)].push_back(event);
+		overflow.pop_back();
+	}
+}
@@ -0,0 +1,86 @@
+﻿/*
+  event_scheduler.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "slot_map.h"
+#include "wave_format.h"
+#include <array>
+#include <vector>
+
+
+
+enum class scheduledEventType {
+	SPAWN,           // a new enemy comes out into the current wave
+	DETECTION_CHECK, // integrate the enemy's detection counter, it may start a blink
+	BLINK,           // the enemy lights up and emits its sound
+	WARP,
+	ZIGZAG_FLIP,
+	DIE              // dying animation is over
+};
+
+struct ScheduledEvent {
+	unsigned int tick = 0;
+	scheduledEventType type = scheduledEventType::SPAWN;
+	SlotHandle enemyHandle;      // checked against the storage when the event fires, stale ones are dropped
+	SpawnRecord spawn{};         // SPAWN only, what to build when it fires
+};
+
+// Timer wheel keyed by simulation tick. Events due within the next wheelSize ticks sit in
+// the slot of their tick, later ones wait in a min-heap and drop into the wheel as it turns.
+// A tick only touches the events that are due, however many enemies are waiting.
+class EventScheduler
+{
+public:
+	static constexpr unsigned int wheelSize = 256; // ~4 s at 60 ticks per second, power of two
+
+	void schedule(const ScheduledEvent& event);
+
+	// Fires every event due up to and including tick, in tick order.
+	// Handlers may schedule more events, ones due now fire in the same call.
+	template<typename Handler>
+	void runDue(unsigned int tick, Handler handler);
+
+	void clear();
+
+	size_t size() const { return pendingCount; }
+	unsigned int getCurrentTick() const { return currentTick; }
+	void setCurrentTick(unsigned int tick) { currentTick = tick; }
+
+private:
+	void pullFromOverflow();
+
+	std::array<std::vector<ScheduledEvent>, wheelSize> slots;
+	std::vector<ScheduledEvent> overflow; // min-heap by tick
+	unsigned int currentTick = 0;         // the next tick runDue will fire
+	size_t pendingCount = 0;
+};
+
+template<typename Handler>
+void EventScheduler::runDue(unsigned int tick, Handler handler)
+{
+	while (currentTick <= tick) {
+		pullFromOverflow();
+
+		// by index, the handler may append to this very slot
+		std::vector<ScheduledEvent>& slot = slots[currentTick & (wheelSize - 1)];
+		for (size_t i = 0; i < slot.size(); i++) {
+			const ScheduledEvent event = slot[i];
+			pendingCount--;
+			handler(event);
+		}
+		slot.clear();
+
+		currentTick++;
+	}
+}
@@ -0,0 +1,85 @@
+﻿/*
+  fft.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "fft.h"
+#include <cmath>
+#include <utility>
+
+
+
+Fft::Fft(size_t newSize) : size(newSize)
+{
+	const double pi = 3.14159265358979323846;
+
+	twiddles.resize(size);
+	for (size_t k = 0; k < size / 2; k++) {
+		twiddles[k * 2] = float(std::cos(-2.0 * pi * double(k) / double(size)));
+		twiddles[k * 2 + 1] = float(std::sin(-2.0 * pi * double(k) / double(size)));
+	}
+
+	unsigned int bits = 0;
+	while ((size_t(1) << bits) < size)
+		bits++;
+
+	bitReversed.resize(size);
+	for (size_t i = 0; i < size; i++) {
+		unsigned int reversed = 0;
+		for (unsigned int b = 0; b < bits; b++) {
+			if (i & (size_t(1) << b))
+				reversed |= 1u << (bits - 1 - b);
+		}
+		bitReversed[i] = reversed;
+	}
+}
+
+void Fft::inverse(float* data) const
+{
+	transform(data, true);
+
+	const float scale = 1.f / float(size);
+	for (size_t i = 0; i < size * 2; i++)
+		data[i] *= scale;
+}
+
+void Fft::transform(float* data, bool isInverse) const
+{
+	for (size_t i = 0; i < size; i++) {
+		const size_t j = bitReversed[i];
+		if (i < j) {
+			std::swap(data[i * 2], data[j * 2]);
+			std::swap(data[i * 2 + 1], data[j * 2 + 1]);
+		}
+	}
+
+	// the inverse is the same butterflies with the twiddles conjugated
+	const float sign = isInverse ? -1.f : 1.f;
+
+	for (size_t half = 1; half < size; half *= 2) {
+		const size_t stride = size / (half * 2);
+		for (size_t start = 0; start < size; start += half * 2) {
+			for (size_t k = 0; k < half; k++) {
+				const float wr = twiddles[k * stride * 2];
+				const float wi = twiddles[k * stride * 2 + 1] * sign;
+
+				float* a = data + (start + k) * 2;
+				float* b = data + (start + k + half) * 2;
+				const float tr = b[0] * wr - b[1] * wi;
+				const float ti = b[0] * wi + b[1] * wr;
+				b[0] = a[0] - tr;
+				b[1] = a[1] - ti;
+				a[0] += tr;
+				a[1] += ti;
+			}
+		}
+	}
+}
@@ -0,0 +1,41 @@
+﻿/*
+  fft.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+
+// In place radix-2 complex FFT of one fixed power of two size. Data is interleaved
+// re, im pairs. Twiddles and the bit reversal order are worked out once up front,
+// so transform() itself never allocates.
+class Fft
+{
+public:
+	explicit Fft(size_t size);
+
+	size_t getSize() const { return size; }
+
+	void forward(float* data) const { transform(data, false); }
+	// includes the 1/size scaling, so forward then inverse gives the input back
+	void inverse(float* data) const;
+
+private:
+	void transform(float* data, bool isInverse) const;
+
+	size_t size;
+	std::vector<float> twiddles;          // cos, sin of -2*pi*k/size for k < size/2
+	std::vector<unsigned int> bitReversed;
+};
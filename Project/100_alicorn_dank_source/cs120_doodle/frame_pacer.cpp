@@ -0,0 +1,230 @@
+﻿/*
+  frame_pacer.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "frame_pacer.h"
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+
+
+namespace {
+	// how early the sleep aims, the timer wakes a little late now and then
+	constexpr std::chrono::microseconds preciseSpinMargin{ 1000 };
+	// a plain Windows timer ticks every 15.6 ms
+	constexpr std::chrono::microseconds coarseSpinMargin{ 16000 };
+	// how much each frame moves getBusyFraction()
+	constexpr float busyFractionBlend = 0.05f;
+}
+
+void FrameTimeHistogram::add(float seconds)
+{
+	const float ms = seconds * 1000.0f;
+	int bucket = int(ms * bucketsPerMs);
+	if (bucket < 0)
+		bucket = 0;
+	else if (bucket >= bucketCount)
+		bucket = bucketCount - 1;
+
+	buckets[bucket]++;
+	count++;
+	if (ms > maxMs)
+		maxMs = ms;
+}
+
+void FrameTimeHistogram::clear()
+{
+	for (unsigned int& bucket : buckets)
+		bucket = 0;
+	count = 0;
+	maxMs = 0.0f;
+}
+
+float FrameTimeHistogram::getPercentileMs(float percentile) const
+{
+	if (count == 0)
+		return 0.0f;
+
+	const float wanted = count * percentile / 100.0f;
+	unsigned int seen = 0;
+	for (int bucket = 0; bucket < bucketCount - 1; bucket++) {
+		seen += buckets[bucket];
+		if (seen >= wanted)
+			return float(bucket + 1) / bucketsPerMs;
+	}
+	return maxMs;
+}
+
+void FrameTimeHistogram::write(std::ostream& file) const
+{
+	file << "# frame time histogram, " << count << " frames, p50 " << getPercentileMs(50.0f) << " ms, p99 "
+		<< getPercentileMs(99.0f) << " ms, max " << maxMs << " ms\n";
+	for (int bucket = 0; bucket < bucketCount; bucket++) {
+		if (buckets[bucket] == 0)
+			continue;
+		if (bucket == bucketCount - 1)
+			file << "over " << (bucketCount - 1) / bucketsPerMs << " " << buckets[bucket] << "\n";
+		else
+			file << float(bucket + 1) / bucketsPerMs << " " << buckets[bucket] << "\n";
+	}
+}
+
+FramePacer::FramePacer()
+{
+#ifdef _WIN32
+	timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	isTimerPrecise = timer != nullptr;
+	if (timer == nullptr) // before Windows 10 1803
+		timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+#else
+	isTimerPrecise = true;
+#endif
+	spinMargin = isTimerPrecise ? Clock::duration(preciseSpinMargin) : Clock::duration(coarseSpinMargin);
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	if (timer != nullptr)
+		CloseHandle(timer);
+#endif
+}
+
+void FramePacer::setTargetRate(int framesPerSecond)
+{
+	targetRate = (framesPerSecond > 0) ? framesPerSecond : 0;
+	updatePeriod();
+}
+
+void FramePacer::setIdleRate(int framesPerSecond)
+{
+	framesPerSecond = (framesPerSecond > 0) ? framesPerSecond : 0;
+	if (framesPerSecond == idleRate)
+		return;
+	idleRate = framesPerSecond;
+	updatePeriod();
+}
+
+void FramePacer::updatePeriod()
+{
+	const int rate = (idleRate > 0) ? idleRate : targetRate;
+	period = (rate > 0) ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate)) : Clock::duration{};
+	deadline = (isStarted ? lastFrame : Clock::now()) + period;
+	isRateChanged = true;
+}
+
+void FramePacer::waitForNextFrame()
+{
+	const bool wasIdle = isIdle();
+	Clock::duration slept{};
+	if (period > Clock::duration{}) {
+		Clock::time_point now = Clock::now();
+		// an idle frame only has to be cheap, not on time
+		const Clock::duration margin = wasIdle ? Clock::duration{} : spinMargin;
+		if (deadline - now > margin) {
+			sleepFor(deadline - now - margin);
+			slept = Clock::now() - now;
+		}
+		while (Clock::now() < deadline)
+			std::this_thread::yield();
+
+		// a frame that ran long starts the schedule over instead of rushing to catch up
+		now = Clock::now();
+		deadline += period;
+		if (deadline < now)
+			deadline = now + period;
+	}
+
+	const Clock::time_point frameStart = Clock::now();
+	if (!isStarted) {
+		isStarted = true;
+		lastFrame = frameStart;
+		return;
+	}
+
+	const float rawDelta = std::chrono::duration<float>(frameStart - lastFrame).count();
+	const float busy = rawDelta - std::chrono::duration<float>(slept).count();
+	lastFrame = frameStart;
+
+	if (wasIdle) {
+		stats.idleFrames++;
+		stats.idleSeconds += rawDelta;
+		stats.idleBusySeconds += busy;
+	}
+	else {
+		stats.activeFrames++;
+		stats.activeSeconds += rawDelta;
+		stats.activeBusySeconds += busy;
+		histogram.add(rawDelta);
+	}
+	if (rawDelta > 0.0f)
+		busyFraction += (busy / rawDelta - busyFraction) * busyFractionBlend;
+
+	float frameDelta = (rawDelta < maxDeltaTime) ? rawDelta : maxDeltaTime;
+	// the frames at the old rate say nothing about the new one
+	if (isRateChanged) {
+		isRateChanged = false;
+		recentCount = 0;
+		recentIndex = 0;
+		if (period > Clock::duration{})
+			frameDelta = std::chrono::duration<float>(period).count();
+	}
+
+	recentDeltas[recentIndex] = frameDelta;
+	recentIndex = (recentIndex + 1) % smoothingFrames;
+	if (recentCount < smoothingFrames)
+		recentCount++;
+
+	float sum = 0.0f;
+	for (int i = 0; i < recentCount; i++)
+		sum += recentDeltas[i];
+	deltaTime = sum / recentCount;
+}
+
+bool FramePacer::save(const char* path) const
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	auto percent = [](double part, double whole) { return (whole > 0.0) ? int(part / whole * 100.0 + 0.5) : 0; };
+	file << "# " << stats.activeFrames << " active frames, busy " << percent(stats.activeBusySeconds, stats.activeSeconds) << "% of "
+		<< stats.activeSeconds << " s\n";
+	file << "# " << stats.idleFrames << " idle frames, busy " << percent(stats.idleBusySeconds, stats.idleSeconds) << "% of "
+		<< stats.idleSeconds << " s\n";
+	histogram.write(file);
+	return bool(file);
+}
+
+void FramePacer::sleepFor(Clock::duration duration)
+{
+#ifdef _WIN32
+	if (timer != nullptr) {
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -LONGLONG(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 100); // relative, 100 ns units
+		if (SetWaitableTimer(timer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+#endif
+	std::this_thread::sleep_for(duration);
+}
@@ -0,0 +1,120 @@
+﻿/*
+  frame_pacer.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+
+
+
+// Frame times in quarter millisecond buckets up to 50 ms, the rest in one more
+class FrameTimeHistogram
+{
+public:
+	static constexpr int bucketsPerMs = 4;
+	static constexpr int bucketCount = 50 * bucketsPerMs + 1;
+
+	void add(float seconds);
+	void clear();
+
+	unsigned int getCount() const { return count; }
+	float getMaxMs() const { return maxMs; }
+	// upper edge of the bucket the percentile falls in, 0 to 100
+	float getPercentileMs(float percentile) const;
+
+	// one line per non-empty bucket: upper edge in ms, frames
+	void write(std::ostream& out) const;
+
+private:
+	unsigned int buckets[bucketCount] = {};
+	unsigned int count = 0;
+	float maxMs = 0.0f;
+};
+
+// Where the wall time of the loop went, busy is everything but the sleep, spinning included
+struct FramePacerStats {
+	unsigned int activeFrames = 0;
+	unsigned int idleFrames = 0;
+	double activeSeconds = 0.0;
+	double activeBusySeconds = 0.0;
+	double idleSeconds = 0.0;
+	double idleBusySeconds = 0.0;
+};
+
+// Keeps the main loop at a steady rate without burning a core on it. Sleeps until just
+// before the next frame is due, on a high resolution timer where there is one, and spins
+// the rest of the way. The frame time it hands out is clamped against spikes (a dragged
+// window, a breakpoint) and averaged over the last few frames.
+class FramePacer
+{
+public:
+	static constexpr float maxDeltaTime = 0.1f;
+	static constexpr int smoothingFrames = 8;
+
+	FramePacer();
+	~FramePacer();
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+
+	// 0 runs as fast as it goes
+	void setTargetRate(int framesPerSecond);
+	int getTargetRate() const { return targetRate; }
+	// Above 0 the loop runs at this rate instead and sleeps the whole wait without spinning,
+	// for screens that hold still and a window in the background
+	void setIdleRate(int framesPerSecond);
+	bool isIdle() const { return idleRate > 0; }
+
+	// At the top of the frame, so the input the frame reads is as fresh as it gets
+	void waitForNextFrame();
+
+	float getDeltaTime() const { return deltaTime; }
+	// for runs without a window that step their own frames
+	void setDeltaTime(float seconds) { deltaTime = seconds; }
+
+	// frame times of the active frames only, an idle frame is slow on purpose
+	const FrameTimeHistogram& getHistogram() const { return histogram; }
+	const FramePacerStats& getStats() const { return stats; }
+	// of the last second or so
+	float getBusyFraction() const { return busyFraction; }
+
+	// stats, then the histogram
+	bool save(const char* path) const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void updatePeriod();
+	void sleepFor(Clock::duration duration);
+
+	int targetRate = 0;
+	int idleRate = 0;
+	bool isRateChanged = false;
+	Clock::duration period{};
+	Clock::duration spinMargin{};
+	Clock::time_point deadline{};
+	Clock::time_point lastFrame{};
+	bool isStarted = false;
+
+	float recentDeltas[smoothingFrames] = {};
+	int recentCount = 0;
+	int recentIndex = 0;
+	float deltaTime = 1.0f / 60.0f;
+
+	FrameTimeHistogram histogram;
+	FramePacerStats stats;
+	float busyFraction = 1.0f;
+
+	void* timer = nullptr; // waitable timer HANDLE on Windows
+	bool isTimerPrecise = false;
+};
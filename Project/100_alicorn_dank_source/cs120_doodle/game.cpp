@@ -14,6 +14,7 @@
 #include "game.h"
 #include "classes.h"
 #include "script.h"
+#include "profiler.h"
 #include "SFML/Audio.hpp"
 
 #include <iostream>
@@ -42,227 +43,327 @@ void operator--(gameState& curState)
 	}
 }
 
-void Game::setup()
+namespace {
+	const char* splashTexturePath = "assets/DigiPen_WHITE_1024px.png";
+	const char* creditTexturePath = "assets/Credit.png";
+	const char* titleTexturePath = "assets/Title.png";
+	const char* instructionTexturePath = "assets/Instruction.png";
+	const char* gameGoalTexturePath = "assets/GG.png";
+
+	// indexed the same way as enemy::audioIndex()
+	const char* gameSoundPaths[] = { "assets/enemy_destroy.wav", "assets/enemy_1.wav", "assets/enemy_1.wav", "assets/enemy_1.wav",
+		"assets/enemy_zigzag.wav", "assets/enemy_warp.wav", "assets/enemy_superfast.wav", "assets/player_hit.wav" };
+}
+
+Game::~Game()
 {
-	if (!isSetted) {
+	for (State* state : states)
+		delete state;
+}
 
-		//statePtr = nullptr;
-		switch (currentState) {
-		case gameState::GAMEPLAY: {
-			playerList.clear();
-			enemyList.clear();
-			statePtr = new GamePlay;
-			isSetted = true;
-			break;
-		}
-		case gameState::CREDIT:
-		{
-			statePtr = new Credit;
-			isSetted = true;
-			break;
-		}
-		case gameState::MAINMENU: {
-			//delete statePtr;
-			statePtr = new MainMenu;
-			isSetted = true;
-			break;
-		}
-		case gameState::GAMEOVER: {
-			for (enemy* enemyInst : enemyList[gameWave]) {
-				sf::Sound& tempSound = enemyInst->audioSource();
-				tempSound.stop();
-			}
-			statePtr = new GameOver;
-			isSetted = true;
-			break;
-		}
-		case gameState::HOWTOPLAY: {
-			statePtr = new HowToPlay;
-			isSetted = true;
-			break;
+// Built the first time it is asked for, the same object every time after that
+State* Game::getState(const gameState& state)
+{
+	State*& slot = states[int(state)];
+	if (slot != nullptr)
+		return slot;
+
+	switch (state) {
+	case gameState::GAMEPLAY: {
+		slot = new GamePlay;
+		break;
+	}
+	case gameState::CREDIT:
+	{
+		slot = new Credit;
+		break;
+	}
+	case gameState::MAINMENU: {
+		slot = new MainMenu;
+		break;
+	}
+	case gameState::GAMEOVER: {
+		slot = new GameOver;
+		break;
+	}
+	case gameState::HOWTOPLAY: {
+		slot = new HowToPlay;
+		break;
+	}
+	default: {
+		slot = new SplashLogo;
+		break;
+	}
+	}
+	slot->setup();
+	return slot;
+}
+
+void Game::setup()
+{
+	const transitionType transition = pendingTransition;
+	pendingTransition = transitionType::NONE;
+
+	switch (transition) {
+	case transitionType::REPLACE: {
+		while (!stateStack.empty()) {
+			stateStack.back()->exit();
+			stateStack.pop_back();
 		}
-		default: {
-			statePtr = new SplashLogo;
-			isSetted = true;
+		stateStack.push_back(getState(pendingState));
+		stateStack.back()->enter();
+		break;
+	}
+	case transitionType::PUSH: {
+		if (!stateStack.empty())
+			stateStack.back()->suspend();
+		stateStack.push_back(getState(pendingState));
+		stateStack.back()->enter();
+		break;
+	}
+	case transitionType::POP: {
+		if (stateStack.empty())
 			break;
-		}
-		}
-		statePtr->setup();
+		stateStack.back()->exit();
+		stateStack.pop_back();
+		if (!stateStack.empty())
+			stateStack.back()->resume();
+		break;
+	}
+	default:
+		break;
 	}
-
 }
 
 void Game::update()
 {
-	if (statePtr != nullptr && isSetted)
-		statePtr->update();
-	else return;
+	PROFILE_SCOPE("Game::update");
+
+	if (!stateStack.empty())
+		stateStack.back()->update();
 }
 
 void Game::toState(const gameState& state)
 {
-	isSetted = false;
-	currentState = state;
+	pendingTransition = transitionType::REPLACE;
+	pendingState = state;
+}
+
+void Game::pushState(const gameState& state)
+{
+	pendingTransition = transitionType::PUSH;
+	pendingState = state;
+}
+
+void Game::popState()
+{
+	pendingTransition = transitionType::POP;
 }
 
 
 void SplashLogo::setup()
 {
+	// the logo first so it is up within a frame or two, then everything the other states will want
+	assetLoader.request(assetKind::TEXTURE, splashTexturePath);
+	for (const char* texturePath : { creditTexturePath, titleTexturePath, instructionTexturePath, gameGoalTexturePath })
+		assetLoader.request(assetKind::TEXTURE, texturePath);
+	for (const char* soundPath : gameSoundPaths)
+		assetLoader.request(assetKind::SOUND, soundPath);
+
+	LoadScript("scripts/script.txt");
+}
 
-	DigipenSplash.LoadFromPNG("assets/DigiPen_WHITE_1024px.png");
-	DigipenSplash.SetSmooth(true);
+void SplashLogo::enter()
+{
+	dt_ = 0.0f;
 
 	set_texture_mode(RectMode::Center);
-
 }
 
 void SplashLogo::update()
 {
-	dt_ += DeltaTime;
+	dt_ += framePacer.getDeltaTime();
 
 	push_settings();
 	set_fill_color(defaultFillColor);
 	set_outline_width(defaultEdgeWidth);
 	set_outline_color(defaultEdgeColor);
-	draw_texture(DigipenSplash, 0.0f, 0.0f, 600, 150);
+	if (const Texture* splash = assetLoader.getTexture(splashTexturePath))
+		draw_texture(*splash, 0.0f, 0.0f, 600, 150);
 	pop_settings();
 
-	if (dt_ > 2.0f) {
+	// stays up past the two seconds if the loader is still busy, nothing after this reads the disk
+	if (dt_ > 2.0f && assetLoader.isIdle()) {
 		newGame.toState(gameState::MAINMENU);
 	}
 }
 
 void GamePlay::setup()
 {
-	sf::Listener::setPosition(0.0f, 0.0f, 0.0f);
-
-	loadSound("assets/enemy_destroy.wav");
-	loadSound("assets/enemy_1.wav");
-	loadSound("assets/enemy_1.wav");
-	loadSound("assets/enemy_1.wav");
-	loadSound("assets/enemy_zigzag.wav");
-	loadSound("assets/enemy_warp.wav");
-	loadSound("assets/enemy_superfast.wav");
-	loadSound("assets/player_hit.wav");
+	// already decoded by the loader during the splash, so these are only cache hits
+	for (const char* soundPath : gameSoundPaths)
+		gameSounds.push_back(soundCache.acquire(soundPath));
+}
 
-	playerList.push_back(new player({ 0.0f, 0.0f }));
-	playerList.back()->addModule(new Wheel());
-	playerList.back()->addModule(new Eye());
-	playerList.back()->addModule(new Ear());
-	playerList.back()->addModule(new Cannon());
+void GamePlay::enter()
+{
+	sf::Listener::setPosition(0.0f, 0.0f, 0.0f);
 
-	//before actual gameplay starts, initialize gameWave to 1
-	gameWave = 1;
+	simulation.setup();
 
 
-	//Load Enemy Info
-	LoadScript("scripts/script.txt");
-	RunScript();
-	UnloadScript();
+	renderer->setShapeModes(EllipseMode::Center, RectMode::Center);
+}
 
+void GamePlay::exit()
+{
+	voiceManager.stopAll();
+	simulation.clear();
+}
 
-	set_frame_of_reference(RightHanded_OriginCenter);
-	set_ellipse_mode(EllipseMode::Center);
-	set_rectangle_mode(RectMode::Center);
+GamePlay::~GamePlay()
+{
+	voiceManager.stopAll();
+	for (const SoundHandle& sound : gameSounds)
+		soundCache.release(sound);
+	gameSounds.clear();
 }
 
 void drawUI() {
 
-	push_settings();
+	renderer->pushSettings();
 
-	set_fill_color(defaultFillColor);
-	no_outline();
-	set_fill_color(red5);
+	renderer->setFill(defaultFillColor);
+	renderer->noOutline();
+	renderer->setFill(red5);
 	float fontSize = 25.f;
-	set_font_size(fontSize);
+	renderer->setFontSize(fontSize);
 
 	string Wave = " Wave " + to_string(gameWave);
 	string Life = " Life " + to_string(playerList[0]->getLife());
 	string EnemySize = " Enemy Left " + to_string(enemyList[gameWave].size());
 
 
-	push_settings();
-	set_fill_color( blue1 );
-	draw_rectangle(-Width * 3.2f / 8, Height * 3.f / 7.f + fontSize * 3.0f / 4, EnemySize.length() * fontSize ,EnemySize.length() * fontSize*1.2f);
+	renderer->pushSettings();
+	renderer->setFill( blue1 );
+	renderer->drawRectangle(-Width * 3.2f / 8, Height * 3.f / 7.f + fontSize * 3.0f / 4, EnemySize.length() * fontSize ,EnemySize.length() * fontSize*1.2f);
 
-	pop_settings();
+	renderer->popSettings();
 
-	draw_text(Wave, -Width * 3.7f / 8, Height * 3.f / 7.f);
+	renderer->drawText(Wave, -Width * 3.7f / 8, Height * 3.f / 7.f);
 
-	draw_text(Life, -Width * 3.7f / 8, Height * 2.5f / 7.f);
+	renderer->drawText(Life, -Width * 3.7f / 8, Height * 2.5f / 7.f);
 
-	draw_text(EnemySize, -Width * 3.7f / 8, Height * 2.f / 7.f);
+	renderer->drawText(EnemySize, -Width * 3.7f / 8, Height * 2.f / 7.f);
 
-	pop_settings();
+	if (isVoiceStatsShown) {
+		const VoiceStats& voices = voiceManager.getStats();
+		renderer->drawText(" Voices " + to_string(voices.realVoices) + " / " + to_string(voices.virtualVoices) + " virtual", -Width * 3.7f / 8, -Height * 2.5f / 7.f);
+		if (voiceManager.isSoftwareMixing())
+			renderer->drawText(" Mix " + to_string(int(voices.mixNsPerVoiceBlock)) + " ns/voice/block", -Width * 3.7f / 8, -Height * 3.f / 7.f);
+		else
+			renderer->drawText(" Stolen " + to_string(voices.stolenTotal) + " Virtualized " + to_string(voices.virtualizedTotal), -Width * 3.7f / 8, -Height * 3.f / 7.f);
+
+		const SoundCacheStats sounds = soundCache.getStats();
+		renderer->drawText(" Sounds " + to_string(sounds.assets) + " " + to_string(sounds.residentBytes / 1024) + "KB", -Width * 3.7f / 8, -Height * 2.f / 7.f);
+	}
+
+	if (isRenderStatsShown) {
+		const RenderStats& draws = renderQueue.getStats();
+		renderer->drawText(" Draws " + to_string(draws.drawCalls) + " State changes " + to_string(draws.stateChanges) + " / " +
+			to_string(draws.unsortedStateChanges) + " unsorted", -Width * 3.7f / 8, -Height * 1.5f / 7.f);
+		const InputLatencyStats& latency = simulation.getInputLatency();
+		renderer->drawText(" Input to fire " + to_string(int(latency.lastMs)) + " ms, " + to_string(int(latency.averageMs)) +
+			" ms average", -Width * 3.7f / 8, -Height * 1.f / 7.f);
+		const FrameTimeHistogram& frames = framePacer.getHistogram();
+		auto tenths = [](float ms) { return to_string(int(ms * 10) / 10) + "." + to_string(int(ms * 10) % 10); };
+		renderer->drawText(" Frame " + tenths(frames.getPercentileMs(50.0f)) + " ms, p99 " + tenths(frames.getPercentileMs(99.0f)) +
+			" ms, max " + tenths(frames.getMaxMs()) + " ms, busy " + to_string(int(framePacer.getBusyFraction() * 100)) + "%",
+			-Width * 3.7f / 8, -Height * 0.5f / 7.f);
+	}
+
+	renderer->popSettings();
 
 }
 
 void GamePlay::update()
 {
-	if (isESCKeyDown) {
-		for (enemy* enemyInst : enemyList[gameWave]) {
-			sf::Sound& tempSound = enemyInst->audioSource();
-			tempSound.stop();
-		}
-		newGame.toState(gameState::MAINMENU);
-		isESCKeyDown = false;
-	}
+	PROFILE_SCOPE("GamePlay::update");
 
-	push_settings();
-	set_fill_color(defaultFillColor);
-	set_outline_width(defaultEdgeWidth);
-	set_outline_color(defaultEdgeColor);
-	pop_settings();
+	if (inputQueue.wasPressed(inputKey::ESCAPE))
+		newGame.toState(gameState::MAINMENU);
 
-	if (enemyList[gameWave].size() == 0 && tempEnemyList[gameWave].size() == 0) {
-		if (gameWave == maxWave) {
-			gameWave = maxWave;
-			LoadScript("scripts/script.txt");
-			RunScript();
-			UnloadScript();
-		}
-		else
-			gameWave++;
+	const float frameStartTime = simulation.getTime();
+	simulation.queueInput(inputQueue.getFrameEvents(), inputQueue.getFrameTime());
+	// in the background the world waits, the input queued meanwhile still goes in
+	simulation.advance(WindowIsFocused ? framePacer.getDeltaTime() : 0.0f);
 
-		for (enemy* enemyInst : tempEnemyList[gameWave])
-			enemyInst->setEmergenceTime(ElapsedTime);
-	}
+	playSoundEvents(frameStartTime);
 
+	for (enemy* instEnemy : enemyList[gameWave])
+		(isProjectionOverlayed) ? (instEnemy->draw()) : (instEnemy->show());
 
+	for (player* instPlayer : playerList)
+		instPlayer->render();
 
-	enemyEmergence();
+	renderQueue.flush(*renderer);
 
-	for (enemy* instEnemy : enemyList[gameWave])
-		instEnemy->update();
+	// the ear has placed every voice by now
+	voiceManager.update(framePacer.getDeltaTime());
 
-	for (player* instPlayer : playerList) {
-		instPlayer->update();
-		if(instPlayer->getLife() <= 0)
-			newGame.toState(gameState::GAMEOVER);
-	};
+	if (simulation.isPlayerDead())
+		newGame.toState(gameState::GAMEOVER);
 
 	drawUI();
 }
 
+void playSoundEvents(float frameStartTime)
+{
+	for (const SoundEvent& event : simulation.getSoundEvents()) {
+		const float delay = event.time - frameStartTime;
+
+		switch (event.type) {
+		case soundEventType::ENEMY_BLINK:
+		case soundEventType::ENEMY_DYING: {
+			if (event.wave != gameWave)
+				break;
+			enemy* enemyInst = enemyList[gameWave].find(event.enemyHandle);
+			if (enemyInst == nullptr) // died within the same frame
+				break;
+			if (event.type == soundEventType::ENEMY_BLINK)
+				enemyInst->playBlinkSound(delay);
+			else
+				enemyInst->playDyingSound(delay);
+			break;
+		}
+		case soundEventType::PLAYER_HIT: {
+			event.playerPtr->playHitSound(delay);
+			break;
+		}
+		}
+	}
+}
+
 
 
 void Credit::setup()
 {
-	Credit.LoadFromPNG("assets/Credit.png");
-	Credit.SetSmooth(true);
+}
 
+void Credit::enter()
+{
 	set_texture_mode(RectMode::Center);
 }
 
 void Credit::update()
 {
-	if (isESCKeyDown){
-		newGame.toState(gameState::MAINMENU);
-		isESCKeyDown = false;
-	}
-		push_settings();
-		draw_texture(Credit, 0.0f, 0.0f, (float)Credit.GetWidth(), (float)Credit.GetHeight());
-		pop_settings();
+	if (inputQueue.wasPressed(inputKey::ESCAPE))
+		newGame.popState(); // back to the menu underneath
+
+	push_settings();
+	if (const Texture* credit = assetLoader.getTexture(creditTexturePath))
+		draw_texture(*credit, 0.0f, 0.0f, (float)credit->GetWidth(), (float)credit->GetHeight());
+	pop_settings();
 }
 
 void MainMenu::setup()
@@ -270,10 +371,23 @@ void MainMenu::setup()
 	buttonList.push_back(new Button(-Width / 4.0f, 0, Width / 2.0f, Height / 10.0f, HexColor{ 0x000000 }, gameState::GAMEPLAY));
 	buttonList.push_back(new Button(-Width / 4.0f, -Height / 6.0f, Width / 2.0f, Height / 10.0f, HexColor{ 0x000000 }, gameState::HOWTOPLAY));
 	buttonList.push_back(new Button(-Width / 4.0f, -Height * 2 / 6.0f, Width / 2.0f, Height / 10.0f, HexColor{ 0x000000 }, gameState::CREDIT));
+}
 
-	title.LoadFromPNG("assets/Title.png");
-	title.SetSmooth(true);
+MainMenu::~MainMenu()
+{
+	for (Button* button : buttonList)
+		delete button;
+}
 
+void MainMenu::enter()
+{
+	playerSelect = gameState::GAMEPLAY;
+	resume();
+}
+
+// the credit and how to play pages change these, the selection is kept
+void MainMenu::resume()
+{
 	set_frame_of_reference(RightHanded_OriginCenter);
 	set_ellipse_mode(EllipseMode::Corner);
 	set_rectangle_mode(RectMode::Corner);
@@ -281,24 +395,39 @@ void MainMenu::setup()
 
 void MainMenu::update()
 {
-	if (isUpKeyDown) {
+	PROFILE_SCOPE("MainMenu::update");
+
+	if (inputQueue.wasPressed(inputKey::UP))
 		--playerSelect;
-		isUpKeyDown = false;
-	}
-	if (isDownKeyDown) {
+	if (inputQueue.wasPressed(inputKey::DOWN))
 		++playerSelect;
-		isDownKeyDown = false;
-	}
-	if (isSpaceKeyDown) {
-		newGame.toState(playerSelect);
-		isSpaceKeyDown = false;
+	if (inputQueue.wasPressed(inputKey::FIRE)) {
+		if (playerSelect == gameState::GAMEPLAY)
+			newGame.toState(playerSelect);
+		else
+			newGame.pushState(playerSelect);
 	}
-	if (isESCKeyDown) {
+	if (inputQueue.wasPressed(inputKey::ESCAPE)) {
 		close_window();
-		isESCKeyDown = false;
 		return;
 	}
 
+	// the title, the buttons and their names are cached, only the outline moves
+	menuLayer.draw([this] { return drawMenuLayer(); });
+
+	for (Button* button : buttonList) {
+		if (playerSelect == button->name) {
+			push_settings();
+			no_fill();
+			set_outline_color(playerEdgeColor);
+			draw_rectangle(button->pos.x, button->pos.y, button->width, button->height);
+			pop_settings();
+		}
+	}
+}
+
+bool MainMenu::drawMenuLayer()
+{
 	for (Button* button : buttonList) {
 		string name;
 		push_settings();
@@ -322,31 +451,30 @@ void MainMenu::update()
 		}
 		}
 
-		if (playerSelect == button->name) {
-			push_settings();
-			no_fill();
-			set_outline_color(playerEdgeColor);
-			draw_rectangle(button->pos.x, button->pos.y, button->width, button->height);
-			set_fill_color(red2);
-			pop_settings();
-
-		}
-		string CopyRight = "All content (c) 2019 DigiPen (USA) Corporation, all rights reserved.";
-
 		push_settings();
-		draw_texture(title, 0.f, Height / 4.f, title.GetWidth() / 2.f, title.GetHeight() / 2.f);
 		float menuFontSize = button->height / 2; 
 		set_font_size(menuFontSize);
 		set_fill_color(red5);
 		int strLen = (int)name.length();
 		draw_text(name, - ((strLen / 2.f) * menuFontSize*3/4), button->pos.y);
-		strLen = (int)CopyRight.length();
-		set_font_size(menuFontSize/2.3f);
-		set_fill_color(HexColor{ 0xFFFFFFFF });
-		draw_text(CopyRight, -((strLen / 2.f) * menuFontSize/2.f * 2.2f / 4), -Height * 3.f / 7.f);
-		
 		pop_settings();
 	}
+
+	const Texture* title = assetLoader.getTexture(titleTexturePath);
+	string CopyRight = "All content (c) 2019 DigiPen (USA) Corporation, all rights reserved.";
+
+	push_settings();
+	if (title != nullptr)
+		draw_texture(*title, 0.f, Height / 4.f, title->GetWidth() / 2.f, title->GetHeight() / 2.f);
+	float menuFontSize = buttonList.front()->height / 2;
+	int strLen = (int)CopyRight.length();
+	set_font_size(menuFontSize/2.3f);
+	set_fill_color(HexColor{ 0xFFFFFFFF });
+	draw_text(CopyRight, -((strLen / 2.f) * menuFontSize/2.f * 2.2f / 4), -Height * 3.f / 7.f);
+	pop_settings();
+
+	// cached without the title it would stay without it
+	return title != nullptr;
 }
 
 void GameOver::setup()
@@ -355,57 +483,41 @@ void GameOver::setup()
 
 void GameOver::update()
 {
-	if (isESCKeyDown) {
+	if (inputQueue.wasPressed(inputKey::ESCAPE)) {
 		newGame.toState(gameState::MAINMENU);
-		isESCKeyDown = false;
 		return;
 	}
-	push_settings();
-	set_fill_color(defaultFillColor);
-	no_outline();
-	set_fill_color(red5);
-	set_font_size(50.0f);
-	string GameOverS = "Game  Over";
-	draw_text(GameOverS, - (float)GameOverS.length()/2.f * 50.0f * 3 / 4, 0);
-	pop_settings();
+	textLayer.draw([] {
+		push_settings();
+		set_fill_color(defaultFillColor);
+		no_outline();
+		set_fill_color(red5);
+		set_font_size(50.0f);
+		string GameOverS = "Game  Over";
+		draw_text(GameOverS, - (float)GameOverS.length()/2.f * 50.0f * 3 / 4, 0);
+		pop_settings();
+		return true;
+	});
 }
 
-void enemyEmergence()
+void HowToPlay::setup()
 {
-	for (vector<enemy*>::iterator it = tempEnemyList[gameWave].begin(); it != tempEnemyList[gameWave].end(); ) {
-		enemy* const tempPtr = *it;
-		if (tempPtr->getEmergenceTime() < ElapsedTime)
-		{ 
-			enemy* tempEnemyPtr = new enemy(*tempPtr);
-			enemyList[gameWave].push_back(tempEnemyPtr);
-			it = tempEnemyList[gameWave].erase(it); 
-		}
-		else ++it; 
-	}
-
 }
 
-void HowToPlay::setup()
+void HowToPlay::enter()
 {
-	Instructions.LoadFromPNG("assets/Instruction.png");
-	Instructions.SetSmooth();
-	GameGoal.LoadFromPNG("assets/GG.png");
-	GameGoal.SetSmooth();
+	isGameGoal = true;
 }
 
 void HowToPlay::update()
 {
-	if (isESCKeyDown) {
-		newGame.toState(gameState::MAINMENU);
-		isESCKeyDown = false;
+	if (inputQueue.wasPressed(inputKey::ESCAPE)) {
+		newGame.popState();
 		return;
 	}
-	if (isSpaceKeyDown) {
+	if (inputQueue.wasPressed(inputKey::FIRE))
 		isGameGoal = false;
-		isSpaceKeyDown = false;
-	}
-	if (isGameGoal)
-		draw_texture(GameGoal, 0.f, 0.f);
-	else
-		draw_texture(Instructions, 0.f, 0.f);
+	const Texture* page = assetLoader.getTexture(isGameGoal ? gameGoalTexturePath : instructionTexturePath);
+	if (page != nullptr)
+		draw_texture(*page, 0.f, 0.f);
 }
@@ -18,6 +18,7 @@
 #include <string>
 #include "doodle/doodle.hpp"
 #include "basic_math.h"
+#include "ui_layer.h"
 
 
 
@@ -32,13 +33,25 @@ enum class gameState : int {
 void operator++(gameState&);
 void operator--(gameState&);
 
+// A state is built once, the first time it is needed, and then kept for the whole run.
+// setup() loads what it owns; enter()/exit() run on every visit, and suspend()/resume()
+// when another state is pushed on top of it and popped off again.
 class State {
 protected:
 
 public:
+	virtual ~State() {}
 	virtual void setup() = 0;
 	virtual void update() = 0;
 
+	virtual void enter() {}
+	virtual void exit() {}
+	virtual void suspend() {}
+	virtual void resume() {}
+
+	// nothing on screen moves until a key is pressed, the loop can slow down
+	virtual bool isStatic() const { return false; }
+
 	State* thisPtr() {
 		return this;
 	}
@@ -46,27 +59,47 @@ public:
 
 class Game {
 private:
-	gameState currentState = gameState::SPLASHLOGO;
-	State* statePtr = nullptr;
-	bool isSetted = false;
+	enum class transitionType {
+		NONE, REPLACE, PUSH, POP };
+
+	static constexpr int stateCount = int(gameState::GAMEOVER) + 1;
+
+	State* states[stateCount] = {};
+	vector<State*> stateStack;
+
+	// requested during update(), carried out by the next setup()
+	transitionType pendingTransition = transitionType::REPLACE;
+	gameState pendingState = gameState::SPLASHLOGO;
+
+	State* getState(const gameState& state);
 
 public:
+	~Game();
+
 	void setup();
 	void update();
+
+	// leaves every state on the stack
 	void toState(const gameState& state);
+	// keeps the current one underneath, suspended
+	void pushState(const gameState& state);
+	void popState();
 
 	State* getStatePtr() {
-		return statePtr;
+		return stateStack.empty() ? nullptr : stateStack.back();
+	}
+	bool isStatic() const {
+		return !stateStack.empty() && stateStack.back()->isStatic();
 	}
 };
 
 class SplashLogo : public State {
 private:
-	Texture        DigipenSplash;
 	float dt_ = 0.0f;
 
 public:
 	void setup() override;
+	void enter() override;
 	void update() override;
 };
 
@@ -75,20 +108,23 @@ enum class ParagraphType {
 };
 
 
-void enemyEmergence();
+void playSoundEvents(float frameStartTime);
 
 class Credit : public State {
-private:
-	Texture        Credit;
 public:
 	void setup() override;
+	void enter() override;
 	void update() override;
+	bool isStatic() const override { return true; }
 };
 
 
 class GamePlay : public State {
 public:
+	~GamePlay();
 	void setup() override;
+	void enter() override;
+	void exit() override;
 	void update() override;
 };
 
@@ -105,28 +141,37 @@ struct Button {
 
 class MainMenu : public State {
 private:
-	Texture title;
 	vector<Button*> buttonList;
 	gameState playerSelect = gameState::GAMEPLAY;
+	UiLayer menuLayer;
+
+	bool drawMenuLayer();
 public:
+	~MainMenu();
 	void setup() override;
+	void enter() override;
+	void resume() override;
 	void update() override;
+	bool isStatic() const override { return true; }
 };
 
 class GameOver : public State {
+private:
+	UiLayer textLayer;
 public:
 	void setup() override;
 	void update() override;
+	bool isStatic() const override { return true; }
 };
 
 class HowToPlay : public State {
 private:
-	Texture Instructions;
-	Texture GameGoal;
 	bool isGameGoal = true;
 public:
 	void setup() override;
+	void enter() override;
 	void update() override;
+	bool isStatic() const override { return true; }
 };
 
 
@@ -27,8 +27,9 @@ GameObject::GameObject(const Vector& newPos2D, int nEdges, HexColor color)
 	}
 	else
 	{
-		vector<Vector> points;
-		points.reserve(nEdges);
+		std::array<Vector, maxPolygonEdges> points;
+		if (nEdges > (int)maxPolygonEdges)
+			nEdges = (int)maxPolygonEdges;
 
 		float d_angle = TWO_PI / (float)nEdges;
 		float startAngle = 0.f;
@@ -41,17 +42,17 @@ GameObject::GameObject(const Vector& newPos2D, int nEdges, HexColor color)
 			float angle = startAngle + (float)i * d_angle;
 			float x = cosf(angle);
 			float y = sinf(angle);
-			points.push_back(Vector(x, y));
+			points[i] = Vector(x, y);
 		}
 
-		for (size_t i = 0; i < points.size() - 1; i++)
+		for (int i = 0; i < nEdges - 1; i++)
 		{
 			const Vector& p1 = points[i];
-			const Vector& p2 = points[i + (size_t)1];
+			const Vector& p2 = points[i + 1];
 			Line edge(p1, p2);
 			edges.push_back(edge);
 		}
-		const Vector& pn = points[points.size() - 1];
+		const Vector& pn = points[nEdges - 1];
 		const Vector& p1 = points[0];
 		Line edge(p1, pn);
 		edges.push_back(edge);
@@ -66,20 +67,12 @@ void GameObject::makeDying()
 {
 }
 
-vector<Line> GameObject::getEdges_GlobalPosition() const
+Polygon GameObject::getEdges_GlobalPosition() const
 {
-	vector<Line> Edges;
-	for (const Line& line : edges)
-	{
-		const Vector& p1 = line.getPoints()[0];
-		const Vector& p2 = line.getPoints()[1];
-		Edges.push_back(Line(p1+pos2D,p2+pos2D));
-	}
-
-	return Edges;
+	return edges.translated(getPos2D());
 }
 
-vector<Line> GameObject::getEdges_RelativePosition() const
+const Polygon& GameObject::getEdges_RelativePosition() const
 {
 	return edges;
 }
@@ -24,9 +24,12 @@ using std::vector;
 
 class GameObject
 {
-	friend bool getFirstObjectHitByRay(const Vector& originPoint, const Vector& endPoint, GameObject*& obj);
+	friend bool isObjectHitByRay(const Line& ray, const GameObject* obj);
+	friend class SpatialGrid;
 public:
 	GameObject(const Vector& newPos2D, int nEdges, HexColor color);
+	// deleted through GameObject* too, enemy::operator delete has to be the one that runs
+	virtual ~GameObject() = default;
 	virtual void update() = 0;
 	virtual void draw() = 0;
 	virtual void show() = 0;
@@ -41,19 +44,25 @@ public:
 		return false;
 	}
 
-	Vector getPos2D() const { return pos2D; }
-	Vector getPos2DProjected() const { return pos2DProjected; }
+	virtual Vector getPos2D() const { return pos2D; }
+	virtual Vector getPos2DProjected() const { return pos2DProjected; }
 
-	vector<Line> getEdges_GlobalPosition()const;
-	vector<Line> getEdges_RelativePosition()const;
+	Polygon getEdges_GlobalPosition()const;
+	const Polygon& getEdges_RelativePosition()const;
 private:
 	bool isCircle = false;
+
+	//bookkeeping for the SpatialGrid
+	bool isInGrid = false;
+	int gridCellX = 0;
+	int gridCellY = 0;
+	unsigned int rayQueryStamp = 0;
 protected:
 	Vector pos2D;
 	Vector pos2DProjected;
 
 	//relative coordinate to parent.
-	vector<Line> edges;
+	Polygon edges;
 	HexColor color;
 };
 
@@ -0,0 +1,251 @@
+﻿/*
+  hrtf.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "hrtf.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+
+namespace {
+	constexpr double pi = 3.14159265358979323846;
+
+	// spherical head model
+	constexpr double headRadius = 0.0875;  // m
+	constexpr double speedOfSound = 343.0; // m/s
+	constexpr size_t modelAzimuthCount = 72;
+	constexpr size_t modelIrLength = 256;
+	constexpr size_t modelFftSize = 512;
+	constexpr double modelBaseDelay = 8.0; // samples, keeps the earliest ear causal
+	constexpr size_t modelFadeLength = 32;
+
+	float wrapDegrees(float degrees)
+	{
+		degrees = std::fmod(degrees, 360.f);
+		return (degrees < 0.f) ? degrees + 360.f : degrees;
+	}
+}
+
+float getHrtfAzimuth(float x, float z)
+{
+	// z is the distance in front of the eye, x to its right
+	return wrapDegrees(float(std::atan2(x, z) * 180.0 / pi));
+}
+
+bool HrtfSet::load(const char* path, unsigned int sampleRate)
+{
+	MappedFile file;
+	if (!file.open(path) || file.size() < sizeof(HrtfFileHeader))
+		return false;
+
+	HrtfFileHeader header;
+	memcpy(&header, file.data(), sizeof(header));
+	if (memcmp(header.magic, hrtfFileMagic, sizeof(header.magic)) != 0 || header.version != hrtfFileVersion ||
+		header.sampleRate != sampleRate || header.irLength == 0 || header.azimuthCount == 0)
+		return false;
+
+	const size_t floatCount = size_t(header.azimuthCount) * 2 * header.irLength;
+	if (file.size() < sizeof(header) + floatCount * sizeof(float))
+		return false;
+
+	std::vector<float> responses(floatCount);
+	memcpy(responses.data(), file.data() + sizeof(header), floatCount * sizeof(float));
+	setResponses(responses.data(), header.azimuthCount, header.irLength);
+	return true;
+}
+
+void HrtfSet::makeSphericalHead(unsigned int sampleRate)
+{
+	const Fft modelFft(modelFftSize);
+	const double omega0 = speedOfSound / headRadius;
+	const double delayScale = headRadius / speedOfSound * sampleRate;
+
+	std::vector<float> responses(modelAzimuthCount * 2 * modelIrLength);
+	std::vector<float> spectrum(modelFftSize * 2);
+
+	for (size_t a = 0; a < modelAzimuthCount; a++) {
+		const double azimuth = double(a) * 360.0 / modelAzimuthCount;
+
+		for (int ear = HRTF_LEFT; ear <= HRTF_RIGHT; ear++) {
+			// angle between the source and the ear's axis, 0 when it points straight at it
+			double incidence = std::fabs(std::fmod(azimuth - (ear == HRTF_LEFT ? 270.0 : 90.0) + 540.0, 360.0) - 180.0);
+			incidence *= pi / 180.0;
+
+			const double alpha = 1.05 + 0.95 * std::cos(incidence * 180.0 / 150.0);
+			const double delay = modelBaseDelay + delayScale * ((incidence < pi / 2) ?
+				1.0 - std::cos(incidence) : 1.0 + incidence - pi / 2);
+
+			for (size_t k = 0; k <= modelFftSize / 2; k++) {
+				const double omega = 2.0 * pi * double(k) * sampleRate / modelFftSize;
+				const double x = omega / (2.0 * omega0);
+
+				// (1 + j*alpha*x) / (1 + j*x), then the delay
+				const double denominator = 1.0 + x * x;
+				const double shadowRe = (1.0 + alpha * x * x) / denominator;
+				const double shadowIm = (alpha * x - x) / denominator;
+				const double phase = -2.0 * pi * double(k) * delay / modelFftSize;
+				const double re = shadowRe * std::cos(phase) - shadowIm * std::sin(phase);
+				const double im = shadowRe * std::sin(phase) + shadowIm * std::cos(phase);
+
+				spectrum[k * 2] = float(re);
+				spectrum[k * 2 + 1] = float(im);
+				if (k > 0 && k < modelFftSize / 2) {
+					spectrum[(modelFftSize - k) * 2] = float(re);
+					spectrum[(modelFftSize - k) * 2 + 1] = float(-im);
+				}
+			}
+			spectrum[modelFftSize + 1] = 0.f; // Nyquist has to be real
+
+			modelFft.inverse(spectrum.data());
+
+			float* response = responses.data() + (a * 2 + ear) * modelIrLength;
+			for (size_t n = 0; n < modelIrLength; n++) {
+				const size_t fromEnd = modelIrLength - n;
+				const float fade = (fromEnd < modelFadeLength) ?
+					float(0.5 - 0.5 * std::cos(pi * double(fromEnd) / modelFadeLength)) : 1.f;
+				response[n] = spectrum[n * 2] * fade;
+			}
+		}
+	}
+
+	setResponses(responses.data(), modelAzimuthCount, modelIrLength);
+}
+
+void HrtfSet::setResponses(const float* responses, size_t newAzimuthCount, size_t irLength)
+{
+	azimuthCount = newAzimuthCount;
+	const size_t usedLength = std::min(irLength, hrtfMaxPartitions * hrtfPartitionSize);
+	partitionCount = (usedLength + hrtfPartitionSize - 1) / hrtfPartitionSize;
+	spectra.assign(azimuthCount * 2 * partitionCount * hrtfBinCount * 2, 0.f);
+
+	const Fft partitionFft(hrtfFftSize);
+	std::vector<float> buffer(hrtfFftSize * 2);
+
+	for (size_t a = 0; a < azimuthCount; a++) {
+		for (int ear = HRTF_LEFT; ear <= HRTF_RIGHT; ear++) {
+			const float* response = responses + (a * 2 + ear) * irLength;
+			for (size_t p = 0; p < partitionCount; p++) {
+				// one partition of taps, zero padded to the FFT size
+				std::fill(buffer.begin(), buffer.end(), 0.f);
+				for (size_t n = 0; n < hrtfPartitionSize && p * hrtfPartitionSize + n < usedLength; n++)
+					buffer[n * 2] = response[p * hrtfPartitionSize + n];
+				partitionFft.forward(buffer.data());
+
+				float* target = spectra.data() + ((a * 2 + ear) * partitionCount + p) * hrtfBinCount * 2;
+				std::copy(buffer.begin(), buffer.begin() + hrtfBinCount * 2, target);
+			}
+		}
+	}
+}
+
+void BinauralVoice::reset()
+{
+	std::fill(std::begin(history), std::end(history), 0.f);
+	for (auto& spectrum : inputSpectra)
+		std::fill(std::begin(spectrum), std::end(spectrum), 0.f);
+	newest = 0;
+	azimuth = 0.f;
+	hasAzimuth = false;
+}
+
+BinauralRenderer::BinauralRenderer(const HrtfSet& newHrtf) : hrtf(newHrtf), fft(hrtfFftSize)
+{
+}
+
+void BinauralRenderer::render(BinauralVoice& voice, const float* input, size_t frames, float azimuth, float* out)
+{
+	const size_t partitionCount = hrtf.getPartitionCount();
+	const size_t azimuthCount = hrtf.getAzimuthCount();
+	if (partitionCount == 0)
+		return;
+
+	// the short way round, so 350 -> 10 does not sweep through the back
+	const float startAzimuth = voice.hasAzimuth ? voice.azimuth : azimuth;
+	float sweep = azimuth - startAzimuth;
+	if (sweep > 180.f)
+		sweep -= 360.f;
+	else if (sweep < -180.f)
+		sweep += 360.f;
+
+	const size_t steps = frames / hrtfPartitionSize;
+	for (size_t step = 0; step < steps; step++) {
+		const float* block = input + step * hrtfPartitionSize;
+
+		// overlap-save: previous and current input, only the second half of the result is kept
+		for (size_t n = 0; n < hrtfPartitionSize; n++) {
+			buffer[n * 2] = voice.history[n];
+			buffer[n * 2 + 1] = 0.f;
+			buffer[(hrtfPartitionSize + n) * 2] = block[n];
+			buffer[(hrtfPartitionSize + n) * 2 + 1] = 0.f;
+		}
+		std::copy(block, block + hrtfPartitionSize, voice.history);
+		fft.forward(buffer);
+
+		voice.newest = (voice.newest + 1) % hrtfMaxPartitions;
+		std::copy(buffer, buffer + hrtfBinCount * 2, voice.inputSpectra[voice.newest]);
+
+		// between which two measured directions, and how far along
+		const float stepAzimuth = wrapDegrees(startAzimuth + sweep * float(step + 1) / float(steps));
+		const float position = stepAzimuth * float(azimuthCount) / 360.f;
+		const size_t lower = size_t(position) % azimuthCount;
+		const size_t upper = (lower + 1) % azimuthCount;
+		const float blend = position - std::floor(position);
+
+		std::fill(std::begin(left), std::end(left), 0.f);
+		std::fill(std::begin(right), std::end(right), 0.f);
+		for (size_t p = 0; p < partitionCount; p++) {
+			const float* x = voice.inputSpectra[(voice.newest + hrtfMaxPartitions - p) % hrtfMaxPartitions];
+			const float* leftA = hrtf.getSpectrum(lower, HRTF_LEFT, p);
+			const float* leftB = hrtf.getSpectrum(upper, HRTF_LEFT, p);
+			const float* rightA = hrtf.getSpectrum(lower, HRTF_RIGHT, p);
+			const float* rightB = hrtf.getSpectrum(upper, HRTF_RIGHT, p);
+
+			for (size_t k = 0; k < hrtfBinCount * 2; k += 2) {
+				const float hlRe = leftA[k] + (leftB[k] - leftA[k]) * blend;
+				const float hlIm = leftA[k + 1] + (leftB[k + 1] - leftA[k + 1]) * blend;
+				const float hrRe = rightA[k] + (rightB[k] - rightA[k]) * blend;
+				const float hrIm = rightA[k + 1] + (rightB[k + 1] - rightA[k + 1]) * blend;
+
+				left[k] += x[k] * hlRe - x[k + 1] * hlIm;
+				left[k + 1] += x[k] * hlIm + x[k + 1] * hlRe;
+				right[k] += x[k] * hrRe - x[k + 1] * hrIm;
+				right[k + 1] += x[k] * hrIm + x[k + 1] * hrRe;
+			}
+		}
+
+		// Both outputs are real, so one inverse FFT of left + i*right gives left in the
+		// real part and right in the imaginary part; the upper bins mirror the lower ones.
+		for (size_t k = 0; k < hrtfBinCount; k++) {
+			const float a = left[k * 2], b = left[k * 2 + 1];
+			const float c = right[k * 2], d = right[k * 2 + 1];
+			buffer[k * 2] = a - d;
+			buffer[k * 2 + 1] = b + c;
+			if (k > 0 && k < hrtfFftSize / 2) {
+				buffer[(hrtfFftSize - k) * 2] = a + d;
+				buffer[(hrtfFftSize - k) * 2 + 1] = c - b;
+			}
+		}
+		fft.inverse(buffer);
+
+		float* target = out + step * hrtfPartitionSize * 2;
+		for (size_t n = 0; n < hrtfPartitionSize; n++) {
+			target[n * 2] += buffer[(hrtfPartitionSize + n) * 2];
+			target[n * 2 + 1] += buffer[(hrtfPartitionSize + n) * 2 + 1];
+		}
+	}
+
+	voice.azimuth = wrapDegrees(startAzimuth + sweep);
+	voice.hasAzimuth = true;
+}
@@ -0,0 +1,110 @@
+﻿/*
+  hrtf.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "fft.h"
+#include <cstdint>
+#include <vector>
+
+
+
+// Horizontal plane HRTF data set, the only plane the game has. All fields little endian.
+//
+//   HrtfFileHeader
+//   float[azimuthCount][2][irLength]   left then right impulse response per azimuth
+//
+// Azimuth i is i * 360 / azimuthCount degrees, 0 straight ahead, clockwise (90 is right).
+
+constexpr char hrtfFileMagic[4] = { 'H', 'R', 'T', 'F' };
+constexpr uint32_t hrtfFileVersion = 1;
+
+struct HrtfFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t sampleRate;
+	uint32_t irLength;
+	uint32_t azimuthCount;
+};
+
+static_assert(sizeof(HrtfFileHeader) == 20, "hrtf file layout changed, bump hrtfFileVersion");
+
+// Uniformly partitioned overlap-save: impulse responses are cut into partitions of
+// hrtfPartitionSize taps and kept as spectra, the input as a delay line of spectra.
+constexpr size_t hrtfPartitionSize = 128;
+constexpr size_t hrtfFftSize = hrtfPartitionSize * 2;
+constexpr size_t hrtfBinCount = hrtfFftSize / 2 + 1;  // the rest mirror these, the signals are real
+constexpr size_t hrtfMaxPartitions = 4;               // 512 taps, longer responses are cut
+
+enum hrtfEar {
+	HRTF_LEFT, HRTF_RIGHT
+};
+
+class HrtfSet
+{
+public:
+	// false if the file is missing, malformed or for another sample rate
+	bool load(const char* path, unsigned int sampleRate);
+	// Brown & Duda spherical head: head shadow filter plus interaural delay. Not as
+	// convincing as a measured set, but front/back and left/right are there.
+	void makeSphericalHead(unsigned int sampleRate);
+
+	size_t getAzimuthCount() const { return azimuthCount; }
+	size_t getPartitionCount() const { return partitionCount; }
+
+	// hrtfBinCount interleaved re, im pairs
+	const float* getSpectrum(size_t azimuth, hrtfEar ear, size_t partition) const
+	{
+		return spectra.data() + ((azimuth * 2 + ear) * partitionCount + partition) * hrtfBinCount * 2;
+	}
+
+private:
+	void setResponses(const float* responses, size_t newAzimuthCount, size_t irLength);
+
+	size_t azimuthCount = 0;
+	size_t partitionCount = 0;
+	std::vector<float> spectra;
+};
+
+// Convolution state of one voice, fixed size so a mixer can keep one per voice slot
+struct BinauralVoice {
+	float history[hrtfPartitionSize];                        // input of the previous partition
+	float inputSpectra[hrtfMaxPartitions][hrtfBinCount * 2];  // newest at newest, then backwards
+	unsigned int newest;
+	float azimuth;  // where the last partition was rendered from, degrees
+	bool hasAzimuth;
+
+	void reset();
+};
+
+class BinauralRenderer
+{
+public:
+	explicit BinauralRenderer(const HrtfSet& newHrtf);
+
+	// Convolves frames (a multiple of hrtfPartitionSize) of dry mono input and adds the
+	// stereo result to out. The azimuth moves from where the voice was last rendered
+	// to azimuth over the partitions, blending neighbouring responses, so a turning
+	// turret sweeps the sound around instead of stepping it.
+	void render(BinauralVoice& voice, const float* input, size_t frames, float azimuth, float* out);
+
+private:
+	const HrtfSet& hrtf;
+	Fft fft;
+	float buffer[hrtfFftSize * 2];
+	float left[hrtfBinCount * 2];
+	float right[hrtfBinCount * 2];
+};
+
+// Direction of a listener relative position, in the same degrees as the data set
+float getHrtfAzimuth(float x, float z);
@@ -0,0 +1,152 @@
+﻿/*
+  input_log.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "input_log.h"
+#include "variables.h"
+#include <cstring>
+#include <fstream>
+
+
+
+namespace {
+	unsigned short getWholeFireHeld(unsigned char keys)
+	{
+		return (keys & inputFlag::fire) ? fullTick : 0;
+	}
+}
+
+void applyInput(const TickInput& input)
+{
+	isUpKeyDown = (input.keys & inputFlag::up) != 0;
+	isDownKeyDown = (input.keys & inputFlag::down) != 0;
+	isLeftKeyDown = (input.keys & inputFlag::left) != 0;
+	isRightKeyDown = (input.keys & inputFlag::right) != 0;
+	isSpaceKeyDown = (input.keys & inputFlag::fire) != 0;
+	isProjectionOverlayed = (input.keys & inputFlag::overlay) != 0;
+}
+
+void InputLog::clear(uint64_t newSeed)
+{
+	changes.clear();
+	seed = newSeed;
+	tickCount = 0;
+	checksum = 0;
+	lastChangeTick = 0;
+	lastKeys = 0;
+}
+
+void InputLog::record(unsigned int tick, const TickInput& input)
+{
+	const bool isPartial = input.fireHeld != getWholeFireHeld(input.keys);
+	if (input.keys == lastKeys && !isPartial)
+		return;
+
+	// 7 bits at a time, low first, the high bit says more follow
+	unsigned int delta = tick - lastChangeTick;
+	while (delta >= 0x80) {
+		changes.push_back((unsigned char)(delta | 0x80));
+		delta >>= 7;
+	}
+	changes.push_back((unsigned char)delta);
+	changes.push_back(isPartial ? (unsigned char)(input.keys | inputFlag::partialFire) : input.keys);
+	if (isPartial) // 0 to 255 when fire ends down, 1 to 256 when it ends up
+		changes.push_back((unsigned char)((input.keys & inputFlag::fire) ? input.fireHeld : input.fireHeld - 1));
+
+	lastChangeTick = tick;
+	lastKeys = input.keys;
+}
+
+void InputLog::finish(unsigned int newTickCount, uint32_t newChecksum)
+{
+	tickCount = newTickCount;
+	checksum = newChecksum;
+}
+
+bool InputLog::save(const char* path) const
+{
+	InputLogHeader header{};
+	memcpy(header.magic, inputLogMagic, sizeof(header.magic));
+	header.version = inputLogVersion;
+	header.seed = seed;
+	header.tickCount = tickCount;
+	header.checksum = checksum;
+	header.changeBytes = uint32_t(changes.size());
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(changes.data()), std::streamsize(changes.size()));
+	return bool(file);
+}
+
+bool InputLog::load(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	InputLogHeader header{};
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+	if (memcmp(header.magic, inputLogMagic, sizeof(header.magic)) != 0 || header.version != inputLogVersion)
+		return false;
+
+	clear(header.seed);
+	changes.resize(header.changeBytes);
+	if (!file.read(reinterpret_cast<char*>(changes.data()), std::streamsize(changes.size())))
+		return false;
+
+	tickCount = header.tickCount;
+	checksum = header.checksum;
+	return true;
+}
+
+InputLog::Reader::Reader(const InputLog& inputLog)
+	: log(inputLog)
+{
+	readNextChange();
+}
+
+TickInput InputLog::Reader::next()
+{
+	TickInput input;
+	input.keys = keys;
+	input.fireHeld = getWholeFireHeld(keys);
+
+	if (hasNextChange && nextChangeTick == tick) {
+		const unsigned char change = log.changes[cursor++];
+		keys = change & (unsigned char)~inputFlag::partialFire;
+		input.keys = keys;
+		input.fireHeld = getWholeFireHeld(keys);
+		if ((change & inputFlag::partialFire) && cursor < log.changes.size()) {
+			const unsigned char fireHeld = log.changes[cursor++];
+			input.fireHeld = (keys & inputFlag::fire) ? fireHeld : (unsigned short)(fireHeld + 1);
+		}
+		readNextChange();
+	}
+	tick++;
+	return input;
+}
+
+void InputLog::Reader::readNextChange()
+{
+	unsigned int delta = 0;
+	int shift = 0;
+	while (cursor < log.changes.size()) {
+		const unsigned char byte = log.changes[cursor++];
+		delta |= unsigned(byte & 0x7F) << shift;
+		shift += 7;
+		if (!(byte & 0x80))
+			break;
+	}
+
+	// a truncated log just keeps the last input
+	hasNextChange = cursor < log.changes.size();
+	nextChangeTick += delta;
+}
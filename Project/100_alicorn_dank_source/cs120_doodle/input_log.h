@@ -0,0 +1,110 @@
+﻿/*
+  input_log.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// What the simulation reads from the keyboard during a tick, one bit each
+namespace inputFlag {
+	constexpr unsigned char up = 1 << 0;
+	constexpr unsigned char down = 1 << 1;
+	constexpr unsigned char left = 1 << 2;
+	constexpr unsigned char right = 1 << 3;
+	constexpr unsigned char fire = 1 << 4;
+	constexpr unsigned char overlay = 1 << 5; // the cannon only fires in the overlay view
+	constexpr unsigned char partialFire = 1 << 7; // only in the log, see InputLog
+}
+
+constexpr unsigned short fullTick = 256;
+
+// What one tick is fed
+struct TickInput {
+	unsigned char keys = 0;       // inputFlag bits down at the end of the tick
+	unsigned short fireHeld = 0;  // how much of the tick fire was down, in 1/fullTick
+};
+
+// sets the key globals the modules read
+void applyInput(const TickInput& input);
+
+//   InputLogHeader
+//   changeBytes bytes of (ticks since the last change as a varint, new keys byte) pairs
+//
+// Holding a key for a minute costs two bytes. A tick where fire was down for only part
+// of it has partialFire set in its keys byte and one more byte with fireHeld: as is when
+// fire is down at the end of the tick, minus one when it is up. The checksum is
+// Simulation::getChecksum() at the end of the session, a replay that does not land on
+// it has diverged.
+constexpr char inputLogMagic[4] = { 'D', 'I', 'N', 'P' };
+constexpr uint32_t inputLogVersion = 2;
+
+struct InputLogHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t seed;
+	uint32_t tickCount;
+	uint32_t checksum;
+	uint32_t changeBytes;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(InputLogHeader) == 32, "input log layout changed, bump inputLogVersion");
+
+// Input of one simulation session, keyed by tick
+class InputLog
+{
+public:
+	void clear(uint64_t newSeed);
+	// every tick, in order
+	void record(unsigned int tick, const TickInput& input);
+	void finish(unsigned int newTickCount, uint32_t newChecksum);
+
+	bool save(const char* path) const;
+	bool load(const char* path);
+
+	uint64_t getSeed() const { return seed; }
+	unsigned int getTickCount() const { return tickCount; }
+	uint32_t getChecksum() const { return checksum; }
+	std::size_t getByteSize() const { return sizeof(InputLogHeader) + changes.size(); }
+
+	// Hands the logged input back one tick at a time
+	class Reader
+	{
+	public:
+		explicit Reader(const InputLog& inputLog);
+		TickInput next();
+
+	private:
+		void readNextChange();
+
+		const InputLog& log;
+		std::size_t cursor = 0;
+		unsigned int tick = 0;
+		unsigned int nextChangeTick = 0;
+		bool hasNextChange = false;
+		unsigned char keys = 0;
+	};
+
+private:
+	std::vector<unsigned char> changes;
+	uint64_t seed = 0;
+	unsigned int tickCount = 0;
+	uint32_t checksum = 0;
+
+	unsigned int lastChangeTick = 0;
+	unsigned char lastKeys = 0;
+};
@@ -15,6 +15,7 @@
 using namespace doodle;
 
 #include "variables.h"
+#include "profiler.h"
 #include "sound.h"
 
 
@@ -22,25 +23,34 @@ using namespace doodle;
 void on_key_pressed(KeyboardButtons button) {
 	switch (button) {
 	case KeyboardButtons::W:
-		isUpKeyDown = true;
+		inputQueue.push(inputKey::UP, true);
 		break;
 	case KeyboardButtons::A:
-		isLeftKeyDown = true;
+		inputQueue.push(inputKey::LEFT, true);
 		break;
 	case KeyboardButtons::S:
-		isDownKeyDown = true;
+		inputQueue.push(inputKey::DOWN, true);
 		break;
 	case KeyboardButtons::D:
-		isRightKeyDown = true;
+		inputQueue.push(inputKey::RIGHT, true);
 		break;
 	case KeyboardButtons::R:
 		isProjectionOverlayed = !isProjectionOverlayed;
 		break;
+	case KeyboardButtons::V:
+		isVoiceStatsShown = !isVoiceStatsShown;
+		break;
+	case KeyboardButtons::F:
+		isRenderStatsShown = !isRenderStatsShown;
+		break;
+	case KeyboardButtons::P:
+		PROFILE_DUMP("trace.json");
+		break;
 	case KeyboardButtons::Space:
-		isSpaceKeyDown = true;
+		inputQueue.push(inputKey::FIRE, true);
 		break;
 	case KeyboardButtons::Escape:
-		isESCKeyDown = true;
+		inputQueue.push(inputKey::ESCAPE, true);
 		break;
 	}
 }
@@ -48,25 +58,25 @@ void on_key_pressed(KeyboardButtons button) {
 void on_key_released(KeyboardButtons button) {
 	switch (button) {
 	case KeyboardButtons::W:
-		isUpKeyDown = false;
+		inputQueue.push(inputKey::UP, false);
 		break;
 	case KeyboardButtons::A:
-		isLeftKeyDown = false;
+		inputQueue.push(inputKey::LEFT, false);
 		break;
 	case KeyboardButtons::S:
-		isDownKeyDown = false;
+		inputQueue.push(inputKey::DOWN, false);
 		break;
 	case KeyboardButtons::D:
-		isRightKeyDown = false;
+		inputQueue.push(inputKey::RIGHT, false);
 		break;
 	case KeyboardButtons::NumPad_5:
 		isStereoReversed = !isStereoReversed;
 		break;
 	case KeyboardButtons::Space:
-		isSpaceKeyDown = false;
+		inputQueue.push(inputKey::FIRE, false);
 		break;
 	case KeyboardButtons::Escape:
-		isESCKeyDown = false;
+		inputQueue.push(inputKey::ESCAPE, false);
 		break;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+﻿/*
+  input_queue.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "input_queue.h"
+#include <chrono>
+
+
+
+void InputQueue::push(inputKey key, bool isPressed)
+{
+	const unsigned int bit = 1u << unsigned(key);
+	heldKeys = isPressed ? (heldKeys | bit) : (heldKeys & ~bit);
+
+	InputEvent event;
+	event.key = key;
+	event.isPressed = isPressed;
+	event.time = now();
+	ring.push(event); // full means nobody has read it for a long time, dropping it is fine
+}
+
+void InputQueue::releaseAll()
+{
+	for (unsigned int key = 0; key < unsigned(inputKey::COUNT); key++) {
+		if (heldKeys & (1u << key))
+			push(inputKey(key), false);
+	}
+}
+
+void InputQueue::beginFrame()
+{
+	frameEvents.clear();
+	InputEvent event;
+	while (ring.pop(event))
+		frameEvents.push_back(event);
+
+	frameTime = now();
+}
+
+bool InputQueue::wasPressed(inputKey key) const
+{
+	for (const InputEvent& event : frameEvents) {
+		if (event.key == key && event.isPressed)
+			return true;
+	}
+	return false;
+}
+
+double InputQueue::now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,63 @@
+﻿/*
+  input_queue.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "spsc_ring.h"
+#include <vector>
+
+
+
+// The first five line up with the inputFlag bits the simulation keeps them in
+enum class inputKey : unsigned char {
+	UP, DOWN, LEFT, RIGHT, FIRE, ESCAPE, COUNT
+};
+
+struct InputEvent {
+	inputKey key = inputKey::ESCAPE;
+	bool isPressed = false;
+	double time = 0.0; // InputQueue::now() when the key callback ran
+};
+
+// Key presses and releases in the order and at the time they happened. The key callbacks
+// push, and once per frame beginFrame() hands everything that came in since to whoever
+// is running: the simulation places each one inside its tick, the menus just look for
+// presses. A tap shorter than a frame is still a press and a release.
+class InputQueue
+{
+public:
+	static constexpr size_t capacity = 256; // a frame's worth of key mashing, with room to spare
+
+	// from the key callbacks
+	void push(inputKey key, bool isPressed);
+	// the window lost focus, whatever it holds will never see its release
+	void releaseAll();
+
+	// once per frame, before the states update
+	void beginFrame();
+	const std::vector<InputEvent>& getFrameEvents() const { return frameEvents; }
+	double getFrameTime() const { return frameTime; }
+
+	// went down during the last frame
+	bool wasPressed(inputKey key) const;
+
+	// seconds on the steady clock
+	static double now();
+
+private:
+	SpscRing<InputEvent, capacity> ring;
+	std::vector<InputEvent> frameEvents;
+	double frameTime = 0.0;
+
+	unsigned int heldKeys = 0; // push() side only, for releaseAll()
+};
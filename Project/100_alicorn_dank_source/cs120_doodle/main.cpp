@@ -19,38 +19,181 @@ using namespace doodle;
 #include "classes.h"
 #include "sound.h"
 #include "game.h"
+#include "simulation.h"
+#include "benchmark.h"
+#include "profiler.h"
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
 
 
 
 void onWindowIsNotFocused() 
 {
-	isUpKeyDown = false;
-	isDownKeyDown = false;
-	isLeftKeyDown = false;
-	isRightKeyDown = false;
+	inputQueue.releaseAll();
 }
 
-int main(void) 
+// Full rate only while the window has focus and something on screen moves. In the
+// background the simulation holds (GamePlay::update) and so do the voices.
+void applyIdlePolicy()
 {
+	voiceManager.setPaused(!WindowIsFocused);
+
+	if (!WindowIsFocused)
+		framePacer.setIdleRate(unfocusedFrameRate);
+	else if (newGame.isStatic())
+		framePacer.setIdleRate(staticScreenFrameRate);
+	else
+		framePacer.setIdleRate(0);
+}
+
+// The argument after argv[index], unless there is none or it is the next option; consumed if taken
+const char* takeArgument(int argc, char* argv[], int& index)
+{
+	if (index + 1 >= argc || strncmp(argv[index + 1], "--", 2) == 0)
+		return nullptr;
+	return argv[++index];
+}
+
+template<size_t count>
+bool isAnyOf(const char* option, const char* const (&names)[count])
+{
+	for (const char* name : names) {
+		if (strcmp(name, option) == 0)
+			return true;
+	}
+	return false;
+}
+
+int toCount(const char* argument)
+{
+	return (argument != nullptr) ? atoi(argument) : 0;
+}
+
+// The modes that run instead of the game, after every option has been applied
+int runMode(const char* mode, const char* first, const char* second)
+{
+	// --headless <ticks> runs the simulation without a window, for profiling and tests
+	if (strcmp(mode, "--headless") == 0)
+		return runHeadless(toCount(first));
+	// --bench-geometry [iterations] exits with 1 if the ray paths allocated or disagreed
+	if (strcmp(mode, "--bench-geometry") == 0)
+		return runGeometryBenchmark(toCount(first));
+	// --soak-states [cycles] exits with 1 if state transitions leaked
+	if (strcmp(mode, "--soak-states") == 0) {
+		create_window(820, 820);
+		return runStateSoak(toCount(first));
+	}
+	// --headless-game <frames> [record file or .png] plays without a window through the null,
+	// recording or software renderer
+	if (strcmp(mode, "--headless-game") == 0)
+		return runHeadlessGame(toCount(first), second);
+	// --bench-raster [frames] [png] times the software rasterizer
+	if (strcmp(mode, "--bench-raster") == 0)
+		return runRasterizerBenchmark(toCount(first), second);
+	// --stress [ticks] [json file] scales synthetic waves up to 100000 enemies
+	if (strcmp(mode, "--stress") == 0)
+		return runStressBenchmark(toCount(first), second);
+	// --replay <file> plays a session saved with --record back headless, exits with 1 if it diverged
+	if (strcmp(mode, "--replay") == 0)
+		return runReplay(first);
+	// --bench-hrtf [voices] exits with 1 if fewer than 64 voices convolve in real time
+	return runHrtfBenchmark(toCount(first));
+}
+
+int main(int argc, char* argv[]) 
+{
+	static const char* const modes[] = { "--headless", "--bench-geometry", "--soak-states", "--headless-game",
+		"--bench-raster", "--stress", "--replay", "--bench-hrtf" };
+	// the ones that can't do without their first argument
+	static const char* const modesWithArgument[] = { "--headless", "--headless-game", "--replay" };
+
+	const char* mode = nullptr;
+	const char* modeArguments[2] = {};
+	const char* histogramPath = nullptr;
+	framePacer.setTargetRate(targetFrameRate);
+
+	// options combine, in any order, each takes the arguments right after it
+	for (int i = 1; i < argc; i++) {
+		const char* option = argv[i];
+
+		// --software-mixer mixes every voice on one stream instead of 32 OpenAL sources
+		if (strcmp(option, "--software-mixer") == 0)
+			voiceManager.enableSoftwareMixer();
+		// --hrtf is the software mixer with every enemy heard through the HRTFs
+		else if (strcmp(option, "--hrtf") == 0)
+			voiceManager.enableSoftwareMixer(true);
+		// --record <file> saves the input of every gameplay session into file, the last one wins
+		else if (strcmp(option, "--record") == 0) {
+			if (const char* path = takeArgument(argc, argv, i))
+				simulation.startRecording(path);
+		}
+		// --fps <rate> [histogram file] paces the loop at rate, 0 for as fast as it goes, and saves
+		// the frame times on exit
+		else if (strcmp(option, "--fps") == 0) {
+			framePacer.setTargetRate(toCount(takeArgument(argc, argv, i)));
+			histogramPath = takeArgument(argc, argv, i);
+		}
+		else if (isAnyOf(option, modes)) {
+			mode = option;
+			modeArguments[0] = takeArgument(argc, argv, i);
+			modeArguments[1] = (modeArguments[0] != nullptr) ? takeArgument(argc, argv, i) : nullptr;
+		}
+		else
+			std::cout << "unknown option " << option << "\n";
+	}
+
+	if (mode != nullptr) {
+		if (isAnyOf(mode, modesWithArgument) && modeArguments[0] == nullptr) {
+			std::cout << mode << " needs an argument\n";
+			return 1;
+		}
+		return runMode(mode, modeArguments[0], modeArguments[1]);
+	}
+
 	create_window(820, 820);
 	toggle_full_screen();
 	show_cursor(false);
 
+	PROFILE_THREAD("main");
+
 	while (!is_window_closed()) 
 	{
-		globalDeltaTime = DeltaTime / targetFrameRate;
+		PROFILE_SCOPE("frame");
+
+		{
+			PROFILE_SCOPE("frame_pacer");
+			framePacer.waitForNextFrame();
+		}
+
+		// textures and sounds the loader threads finished since last frame
+		assetLoader.pump();
+		// keys that came in with the last update_window()
+		inputQueue.beginFrame();
 
 		newGame.setup();
 
 		if (!WindowIsFocused) onWindowIsNotFocused();
+		applyIdlePolicy();
 
 		clear_background(defaultFillColor);
 
+		renderer->beginFrame();
 		newGame.update();
+		renderer->endFrame();
 
-		update_window(); // Screen gets updated here, don't forget
+		{
+			PROFILE_SCOPE("update_window");
+			update_window(); // Screen gets updated here, don't forget
+		}
 
 	}
 
+	assetLoader.shutdown();
+	simulation.stopRecording(); // closed in the middle of a session
+	if (histogramPath != nullptr)
+		framePacer.save(histogramPath);
+	PROFILE_DUMP("trace_exit.json");
+
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+﻿/*
+  mapped_file.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+
+
+// Read-only memory mapping of a whole file. The OS pages it in on first touch,
+// so opening costs the same however big the file is.
+class MappedFile
+{
+public:
+	MappedFile() {}
+	~MappedFile() { close(); }
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const char* path);
+	void close();
+
+	bool isOpen() const { return bytes != nullptr; }
+	const unsigned char* data() const { return bytes; }
+	size_t size() const { return byteCount; }
+
+private:
+	const unsigned char* bytes = nullptr;
+	size_t byteCount = 0;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
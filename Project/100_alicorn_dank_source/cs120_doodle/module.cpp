@@ -17,6 +17,9 @@
 #include "player.h"
 #include "enemy.h"
 #include "classes.h"
+#include "useful_functions.h"
+#include "batch_projection.h"
+#include "profiler.h"
 #include <doodle/doodle.hpp>
 using namespace doodle;
 
@@ -50,9 +53,8 @@ void Module::syncRotation() {
 
 void Wheel::update()
 {
+	PROFILE_SCOPE("Wheel::update");
 	syncRotation();
-
-	(isProjectionOverlayed) ? (draw()) : (show());
 }
 
 void Wheel::move() {
@@ -76,151 +78,117 @@ void Wheel::move() {
 
 void Wheel::show()
 {
-	push_settings();
-
-	pop_settings();
 }
 
 void Wheel::draw()
 {
-	push_settings();
-
-	pop_settings();
 }
 
 
 
 void Ear::update()
 {
+	PROFILE_SCOPE("Ear::update");
 	
 	syncRotation();
 	
-	percept();
-
-	(isProjectionOverlayed) ? (draw()) : (show());
-	
 }
 
 void Ear::percept()
 {
-	for (enemy* instEnemy : enemyList[gameWave]) {
-		Sound& enemyAudio = instEnemy->audioSource();
-
-		if (!isStereoReversed) {
-			enemyAudio.setPosition(Vector3f(instEnemy->getPos2DProjected().x, 0.0f, instEnemy->getPos2DProjected().y));
-		}
-		else {
-			enemyAudio.setPosition(Vector3f(-instEnemy->getPos2DProjected().x, 0.0f, instEnemy->getPos2DProjected().y));
-		}
-
-	}
+	EnemyStorage& enemies = enemyList[gameWave];
+	const float stereoSign = isStereoReversed ? -1.0f : 1.0f;
+
+	// enemies of an older wave, or already removed, have nothing left to say
+	voiceManager.positionEnemyVoices([&](const SlotHandle& handle, unsigned int wave, Vector3f& position) {
+		if (wave != gameWave || !enemies.contains(handle))
+			return false;
+		const size_t row = enemies.rowOf(handle);
+		position = Vector3f(stereoSign * enemies.projectedX[row], 0.0f, enemies.projectedY[row]);
+		return true;
+	});
 }
 
+// What the ear hears is presented once per rendered frame, same as what the eye sees
 void Ear::show()
 {
-	push_settings();
-
-	pop_settings();
+	voiceManager.setDistanceModel(500.0f, 0.3f);
+	percept();
 }
 
 void Ear::draw()
 {
-	push_settings();
-
-	pop_settings();
+	voiceManager.setDistanceModel(100.0f, 0.6f);
+	percept();
 }
 
 
 
 void Eye::update() 
 {
+	PROFILE_SCOPE("Eye::update");
 
 	syncRotation();
 
 	percept();
-
-	(isProjectionOverlayed) ? (draw()) : (show());
 	
 }
 
 void Eye::percept() // gives enemy their initial 'projected' position vector
 {
-	for (enemy* instEnemy : enemyList[gameWave]) {
-
-		Vector lineVector;
-		lineVector.x = -rotationVector.y;
-		lineVector.y = rotationVector.x;
-
-		Vector posVector;
-		mother->syncPos2D(posVector);
-
-		Vector vectorToProject;
-		instEnemy->syncPos2D(vectorToProject);
-
-
-
-		Vector projectedVector;
-
-		float lineVectorLength = returnVectorLength(lineVector);
-
-		projectedVector = posVector + lineVector * 
-			((lineVector * (vectorToProject - posVector)) / 
-			(lineVectorLength * lineVectorLength));
-
-		Vector projectedEnemyX = (projectedVector - posVector);
-		Vector projectedEnemyY = (vectorToProject - projectedVector);
-
-		Vector perceptedEnemyVector{ returnVectorLength(projectedEnemyX), returnVectorLength(projectedEnemyY) };
-
-		Vector vectorPlayerToEnemy{ (vectorToProject - posVector).x, (vectorToProject - posVector).y };
-
-
-
-		if (vectorPlayerToEnemy.x * lineVector.y - vectorPlayerToEnemy.y * lineVector.x < 0) perceptedEnemyVector.y *= -1;
-		if (vectorPlayerToEnemy.x * rotationVector.y - vectorPlayerToEnemy.y * rotationVector.x < 0) perceptedEnemyVector.x *= -1;
-
-
-
-		instEnemy->projectPos2D(perceptedEnemyVector);
-
-
-
-		push_settings(); // The minimal indication of player rotation
-
-		set_outline_color(HexColor(red3));
-		set_outline_width(defaultEdgeWidth * 2);
-
-		draw_line(0, 0,
-			0 + -rotationVector.x * playerDrawSize * 3 / 4, 0 + rotationVector.y * playerDrawSize * 3 / 4);
+	EnemyStorage& enemies = enemyList[gameWave];
+	const size_t count = enemies.size();
+
+	Vector posVector;
+	mother->syncPos2D(posVector);
+
+	// keep last tick's projection around so rendering can interpolate between the two
+	enemies.prevProjectedX.assign(enemies.projectedX.begin(), enemies.projectedX.end());
+	enemies.prevProjectedY.assign(enemies.projectedY.begin(), enemies.projectedY.end());
+
+	projectBatch(enemies.posX.data(), enemies.posY.data(), count,
+		posVector.x, posVector.y, rotationVector.x, rotationVector.y,
+		enemies.projectedX.data(), enemies.projectedY.data());
+
+	// a fresh enemy has nothing to interpolate from yet
+	unsigned char* flags = enemies.flags.data();
+	for (size_t i = 0; i < count; i++) {
+		if (!(flags[i] & enemyFlag::projected)) {
+			enemies.prevProjectedX[i] = enemies.projectedX[i];
+			enemies.prevProjectedY[i] = enemies.projectedY[i];
+			flags[i] |= enemyFlag::projected;
+		}
+	}
+}
 
-		set_outline_color(HexColor(blue3));
-		set_outline_width(defaultEdgeWidth * 2);
-		draw_line(0, 0,
-			0 + rotationVector.x * playerDrawSize * 3 / 4, 0 + -rotationVector.y * playerDrawSize * 3 / 4);
+void Eye::drawRotationIndicator()
+{
+	if (enemyList[gameWave].empty())
+		return;
 
-		pop_settings();
+	// The minimal indication of player rotation
+	renderQueue.drawLine(renderLayer::INDICATOR, RenderState().setOutline(HexColor(red3), defaultEdgeWidth * 2), 0, 0,
+		0 + -rotationVector.x * playerDrawSize * 3 / 4, 0 + rotationVector.y * playerDrawSize * 3 / 4);
 
-	}
+	renderQueue.drawLine(renderLayer::INDICATOR, RenderState().setOutline(HexColor(blue3), defaultEdgeWidth * 2), 0, 0,
+		0 + rotationVector.x * playerDrawSize * 3 / 4, 0 + -rotationVector.y * playerDrawSize * 3 / 4);
 }
 
 void Eye::show()
 {
-	push_settings();
-
-	pop_settings();
+	drawRotationIndicator();
 }
 
 void Eye::draw()
 {
-	push_settings();
-
-	pop_settings();
+	drawRotationIndicator();
 }
 
 
 
 void Cannon::update()
 {
+	PROFILE_SCOPE("Cannon::update");
 
 	bool& isPlayerFiring = mother->getFireRef();
 
@@ -235,43 +203,30 @@ void Cannon::update()
 		isPlayerFiring = false;
 	}
 
-	if (isSpaceKeyDown && isProjectionOverlayed)
+	// charges for exactly as long as space was down in this tick, even a tap between two ticks
+	const float heldTime = simulation.getFireHeldTime();
+	if (heldTime > 0.f && isProjectionOverlayed && !mother->isFiring)
 	{
-		if(!mother->isFiring)
-		if (!isCharging)
-		{		
-			isCharging = true;
-		}
-		else
-		{
-			charge();
-		}
+		isCharging = true;
+		charge(heldTime);
 	}
-	else //when space is released
+
+	if (isCharging && !(isSpaceKeyDown && isProjectionOverlayed)) //when space is released
 	{
-		if (isCharging) {
-			isPlayerFiring = true;
-			fireCount = chargedRange / 1000;
-			fire();
-		}
+		isPlayerFiring = true;
+		fireCount = chargedRange / 1000;
+		fire();
 	}
 
-	(isProjectionOverlayed) ? (draw()) : (show());
-
 }
 
 void Cannon::show()
 {
 
-	push_settings();
-	apply_translate(0, 0);
-	apply_rotate(HALF_PI);
+	const RenderState state = RenderState().setFill(red1);
 
-	set_fill_color(red1);
-
-	draw_rectangle(15, 10, 15, 5);
-	draw_rectangle(15, -10, 15, 5);
-	pop_settings();
+	renderQueue.drawRectangle(renderLayer::CANNON, state, 15, 10, 15, 5, HALF_PI);
+	renderQueue.drawRectangle(renderLayer::CANNON, state, 15, -10, 15, 5, HALF_PI);
 }
 
 void Cannon::draw()
@@ -279,10 +234,7 @@ void Cannon::draw()
 
 	if (isCharging) {
 
-		push_settings();
-
-		set_outline_color(blue1);
-		set_outline_width(5);
+		const RenderState state = RenderState().setOutline(blue1, 5);
 
 		Vector tempVectorSideLeft{ maxCannonWidth, windowBaseDepth };
 		Vector tempVectorSideRight{ -maxCannonWidth, windowBaseDepth };
@@ -295,29 +247,23 @@ void Cannon::draw()
 		tempVectorSideLeft *= ((tempChargedRange + baseCannonDrawDistance) / maxCannonRange);
 		tempVectorSideRight *= ((tempChargedRange + baseCannonDrawDistance) / maxCannonRange);
 
-		draw_line(maxCannonWidth, -windowBaseDepth, maxCannonWidth + tempVectorSideRight.x, -windowBaseDepth + tempVectorSideRight.y);
-		draw_line(-maxCannonWidth, -windowBaseDepth, -maxCannonWidth + tempVectorSideLeft.x, -windowBaseDepth + tempVectorSideLeft.y);
-
-		pop_settings();
+		renderQueue.drawLine(renderLayer::BEAM, state, maxCannonWidth, -windowBaseDepth, maxCannonWidth + tempVectorSideRight.x, -windowBaseDepth + tempVectorSideRight.y);
+		renderQueue.drawLine(renderLayer::BEAM, state, -maxCannonWidth, -windowBaseDepth, -maxCannonWidth + tempVectorSideLeft.x, -windowBaseDepth + tempVectorSideLeft.y);
 
 	}
 
 	if (mother->getFireRef()) {
 
-		push_settings();
-
 		unsigned int tempColor = 0xFF;
 
 		tempColor |= (55 << 24);
-		tempColor |= (int(200 * random(0.f, 1.f)) << 16);
-		tempColor |= (int(255 * random(0.8f, 1.f)) << 8);
+		tempColor |= (int(200 * cosmeticRandom.nextFloat(0.f, 1.f)) << 16);
+		tempColor |= (int(255 * cosmeticRandom.nextFloat(0.8f, 1.f)) << 8);
 
 		HexColor tempHex;
 		tempHex.rgba = tempColor;
 
-		set_fill_color(tempHex);
-
-		float width = float(random(0.f, maxCannonWidth));
+		float width = cosmeticRandom.nextFloat(0.f, maxCannonWidth);
 
 		Vector vectorSideLeft{ width, windowBaseDepth };
 		Vector vectorSideRight{ -width, windowBaseDepth };
@@ -328,44 +274,30 @@ void Cannon::draw()
 		vectorSideLeft *= ((shotRange + baseCannonDrawDistance) / maxCannonRange);
 		vectorSideRight *= ((shotRange + baseCannonDrawDistance) / maxCannonRange);
 
-		draw_quad(width, -windowBaseDepth, -width, -windowBaseDepth, 
+		renderQueue.drawQuad(renderLayer::BEAM, RenderState().setFill(tempHex), width, -windowBaseDepth, -width, -windowBaseDepth, 
 			-width + vectorSideLeft.x, -windowBaseDepth + vectorSideLeft.y, width + vectorSideRight.x, -windowBaseDepth + vectorSideRight.y);
 
-		pop_settings();
-
 	}
 
 	// Draw Cannon itself in first person view
-	push_settings();
-
-	push_settings();
 	float shakeX = 0;
 	float shakeY = 0;
-	shakeX = float(mother->shakingTime) * random(-1.f, 1.f);
-	shakeY = float(mother->shakingTime) * random(-1.f, 1.f);
+	float shake = mother->shakingTime / mother->initShakingTime * maxShake;
+	shakeX = shake * cosmeticRandom.nextFloat(-1.f, 1.f);
+	shakeY = shake * cosmeticRandom.nextFloat(-1.f, 1.f);
 	
-	set_fill_color(red1);
-	apply_rotate(0.65f);
-	draw_rectangle(30 + shakeX, -600 + shakeY, 75, 600);
+	const RenderState barrel = RenderState().setFill(red1);
+	renderQueue.drawRectangle(renderLayer::CANNON, barrel, 30 + shakeX, -600 + shakeY, 75, 600, 0.65f);
+	renderQueue.drawRectangle(renderLayer::CANNON, barrel, -30 + shakeX, -600 + shakeY, 75, 600, -0.65f);
 
-	apply_rotate(-1.3f);
-	draw_rectangle(-30 + shakeX, -600 + shakeY, 75, 600);
-	pop_settings();
-	if (isAnythingInRange)
-		set_fill_color(155, 255, 55, 255);
-	else
-		set_fill_color(255, 255, 255, 255);
-
-	draw_triangle(0, 15.f, -10.f, -10.f, 10.f, -10.f);
-
-	pop_settings();
+	const RenderState sight = RenderState().setFill(HexColor{ isAnythingInRange ? 0x9BFF37FFu : 0xFFFFFFFFu });
+	renderQueue.drawTriangle(renderLayer::SIGHT, sight, 0, 15.f, -10.f, -10.f, 10.f, -10.f);
 }
 
-void Cannon::charge()
+void Cannon::charge(float heldTime)
 {
-	if (chargedRange < maxCannonRange)
-		chargedRange += deltaChargeRange;
-	else
+	chargedRange += chargeSpeed * heldTime;
+	if (chargedRange > maxCannonRange)
 		chargedRange = maxCannonRange;
 
 	GameObject* obj;
@@ -394,4 +326,6 @@ void Cannon::fire()
 	shotRange = chargedRange;
 	isCharging = false;
 	chargedRange = initChargedRange;
+
+	simulation.noteShot();
 }
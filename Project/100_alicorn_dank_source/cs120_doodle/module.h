@@ -31,6 +31,7 @@ protected:
 
 public:
 	Module() {};
+	virtual ~Module() {};
 
 	virtual void update() = 0;
 	virtual void show() = 0;
@@ -88,6 +89,9 @@ public:
 
 	void percept();
 
+private:
+	void drawRotationIndicator();
+
 };
 
 class Cannon : public Module
@@ -98,14 +102,15 @@ public:
 	void update() override;
 	void show() override;
 	void draw() override;
-	void charge();
+	void charge(float heldTime);
 	void fire();
 private:
 	bool isCharging = false;
 	float initChargedRange = 0.f;
 	float chargedRange = initChargedRange;
 	float shotRange = 0.f;
-	const float deltaChargeRange = 5.f;
+	const float chargeSpeed = 300.f; // range per second
+	const float maxShake = 60.f;
 
 	bool isAnythingInRange = false;
 
@@ -28,9 +28,25 @@ void player::update()
 		instModule->update(); 
 	}
 
-	(isProjectionOverlayed) ? (draw()) : (show());
 	if (shakingTime > 0)
-		shakingTime--;
+		shakingTime -= globalDeltaTime;
+}
+
+void player::render()
+{
+
+	for (Module* instModule : moduleList) {
+		(isProjectionOverlayed) ? (instModule->draw()) : (instModule->show());
+	}
+
+	(isProjectionOverlayed) ? (draw()) : (show());
+}
+
+player::~player()
+{
+	for (Module* instModule : moduleList) {
+		delete instModule;
+	}
 }
 
 
@@ -46,31 +62,25 @@ void player::addModule(Module* module)
 void player::show() 
 {
 
-	push_settings();
-
-	set_fill_color(playerFillColor);
-	set_outline_color(playerEdgeColor);
+	const RenderState state = RenderState().setFill(playerFillColor).setOutline(playerEdgeColor, defaultDrawOutlineWidth);
 
-	draw_ellipse(pos2DProjected.x, pos2DProjected.y, playerDrawSize, playerDrawSize);
-	draw_ellipse(pos2DProjected.x, pos2DProjected.y, playerDrawSize / 1.3f, playerDrawSize / 1.3f);
-
-	pop_settings();
+	renderQueue.drawEllipse(renderLayer::PLAYER, state, pos2DProjected.x, pos2DProjected.y, playerDrawSize, playerDrawSize);
+	renderQueue.drawEllipse(renderLayer::PLAYER, state, pos2DProjected.x, pos2DProjected.y, playerDrawSize / 1.3f, playerDrawSize / 1.3f);
 
 }
 
 void player::onHit()
 {
 	life--;
-	sound.setBuffer(SoundBuffers[7]);
-	sound.play();
+	simulation.queueSound(SoundEvent{ soundEventType::PLAYER_HIT, gameWave, SlotHandle{}, this });
 	shakingTime = initShakingTime;
 }
 
-void player::draw() 
+void player::playHitSound(float delay)
 {
+	voiceManager.playPlayer(gameSounds[7], delay);
+}
 
-	push_settings();
-
-	pop_settings();
-
+void player::draw() 
+{
 }
\ No newline at end of file
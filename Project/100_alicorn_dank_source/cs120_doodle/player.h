@@ -32,6 +32,9 @@ public:
 	virtual void show() override;
 	virtual void onHit()override;
 
+	void render();
+	void playHitSound(float delay);
+
 	void addModule(Module* module);	
 
 	const int& getLife() const {
@@ -45,17 +48,17 @@ public:
 	bool& getFireRef() { return isFiring; };
 
 	player(Vector newPos2D) : GameObject(newPos2D, 6, red3) {};
+	~player();
 
 protected:
 
 	vector<Module*> moduleList;
 
 	bool isDead = false;
-	sf::Sound sound;
 	bool isFiring = false;
 	int life = playerLife;
-	int initShakingTime = 60;
-	int shakingTime = 0;
+	float initShakingTime = 1.0f; // seconds
+	float shakingTime = 0;
 };
 
 
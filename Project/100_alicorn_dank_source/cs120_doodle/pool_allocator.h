@@ -0,0 +1,79 @@
+﻿/*
+  pool_allocator.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+
+
+// Fixed size blocks for objects of type T, carved out of chunks of blocksPerChunk.
+// Freed blocks go on a free list and are handed out again before a new chunk is made,
+// so a game that keeps spawning and killing enemies stops touching the heap after warm-up.
+// Chunks are only returned when the pool itself goes away.
+template<typename T, size_t blocksPerChunk = 128>
+class PoolAllocator
+{
+public:
+	PoolAllocator() {}
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	void* allocate()
+	{
+		if (freeList == nullptr)
+			addChunk();
+
+		Block* block = freeList;
+		freeList = block->next;
+		inUse++;
+		return block;
+	}
+
+	void deallocate(void* ptr)
+	{
+		if (ptr == nullptr)
+			return;
+
+		Block* block = static_cast<Block*>(ptr);
+		block->next = freeList;
+		freeList = block;
+		inUse--;
+	}
+
+	size_t getBlocksInUse() const { return inUse; }
+	size_t getCapacity() const { return chunks.size() * blocksPerChunk; }
+
+private:
+	union Block {
+		Block* next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	void addChunk()
+	{
+		chunks.emplace_back(new Block[blocksPerChunk]);
+		Block* chunk = chunks.back().get();
+		for (size_t i = 0; i < blocksPerChunk; i++) {
+			chunk[i].next = freeList;
+			freeList = &chunk[i];
+		}
+	}
+
+	std::vector<std::unique_ptr<Block[]>> chunks;
+	Block* freeList = nullptr;
+	size_t inUse = 0;
+};
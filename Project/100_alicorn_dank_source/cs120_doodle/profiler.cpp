@@ -0,0 +1,90 @@
+﻿/*
+  profiler.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "profiler.h"
+
+#ifdef DANK_PROFILE
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+
+Profiler profiler;
+
+ProfileBuffer* Profiler::addThread()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	buffers.push_back(std::make_unique<ProfileBuffer>());
+	threadProfileBuffer = buffers.back().get();
+	threadProfileBuffer->threadId = unsigned(buffers.size());
+	return threadProfileBuffer;
+}
+
+void Profiler::setThreadName(const char* name)
+{
+	if (threadProfileBuffer == nullptr)
+		addThread();
+	threadProfileBuffer->threadName = name;
+}
+
+// Other threads keep writing while this runs; whatever they may have overwritten in the
+// meantime is dropped instead of being written out half torn.
+bool Profiler::dump(const char* path)
+{
+	std::ofstream file(path);
+	if (!file) {
+		std::cout << "could not write " << path << "\n";
+		return false;
+	}
+
+	std::vector<ProfileEvent> events;
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool isFirst = true;
+
+	std::lock_guard<std::mutex> guard(lock);
+	for (const std::unique_ptr<ProfileBuffer>& buffer : buffers) {
+		const uint64_t end = buffer->written.load(std::memory_order_acquire);
+		uint64_t begin = (end > ProfileBuffer::capacity) ? end - ProfileBuffer::capacity : 0;
+		events.clear();
+		for (uint64_t i = begin; i < end; i++)
+			events.push_back(buffer->events[i & (ProfileBuffer::capacity - 1)]);
+
+		// the slot of index writtenSince may be half written by now, so it counts as overwritten too
+		const uint64_t writtenSince = buffer->written.load(std::memory_order_acquire);
+		const uint64_t skip = (writtenSince + 1 > ProfileBuffer::capacity + begin) ? writtenSince + 1 - ProfileBuffer::capacity - begin : 0;
+
+		file << (isFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+			<< ",\"args\":{\"name\":\"" << (buffer->threadName != nullptr ? buffer->threadName : "thread") << "\"}}";
+		isFirst = false;
+
+		for (size_t i = size_t(skip); i < events.size(); i++) {
+			const ProfileEvent& event = events[i];
+			// complete events; the viewer nests them by time
+			file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+				<< ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	if (!file) {
+		std::cout << "could not write " << path << "\n";
+		return false;
+	}
+	std::cout << "profile written to " << path << "\n";
+	return true;
+}
+
+#endif
@@ -0,0 +1,111 @@
+﻿/*
+  profiler.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+
+
+// PROFILE_SCOPE("name") times the rest of the enclosing block. Every thread writes its
+// own ring buffer of the most recent scopes, nothing is shared or locked on the way in.
+// PROFILE_DUMP("file.json") writes what the rings still hold as Chrome trace_event JSON,
+// open it in chrome://tracing or ui.perfetto.dev.
+//
+// All of it only exists when DANK_PROFILE is defined; otherwise the macros expand to
+// nothing and the game is built exactly as before.
+#ifdef DANK_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ProfileEvent {
+	const char* name;
+	int64_t start;  // ns since the profiler started
+	int64_t end;
+};
+
+struct ProfileBuffer {
+	static constexpr size_t capacity = 1 << 16;
+
+	ProfileEvent events[capacity];
+	std::atomic<uint64_t> written{ 0 };
+	const char* threadName = nullptr;
+	unsigned int threadId = 0;
+};
+
+inline thread_local ProfileBuffer* threadProfileBuffer = nullptr;
+
+class Profiler
+{
+public:
+	Profiler() : origin(std::chrono::steady_clock::now()) {}
+
+	int64_t now() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+	}
+
+	void record(const char* name, int64_t start, int64_t end)
+	{
+		ProfileBuffer* buffer = threadProfileBuffer;
+		if (buffer == nullptr)
+			buffer = addThread();
+		// only this thread writes here; the oldest event is simply overwritten
+		const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+		buffer->events[index & (ProfileBuffer::capacity - 1)] = ProfileEvent{ name, start, end };
+		buffer->written.store(index + 1, std::memory_order_release);
+	}
+
+	void setThreadName(const char* name);
+	bool dump(const char* path);
+
+private:
+	ProfileBuffer* addThread();
+
+	const std::chrono::steady_clock::time_point origin;
+	std::mutex lock;
+	std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+};
+
+extern Profiler profiler;
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* newName) : name(newName), start(profiler.now()) {}
+	~ProfileScope() { profiler.record(name, start, profiler.now()); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* name;
+	int64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD(name) profiler.setThreadName(name)
+#define PROFILE_DUMP(path) profiler.dump(path)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#define PROFILE_DUMP(path)
+
+#endif
@@ -0,0 +1,65 @@
+﻿/*
+  random_stream.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+
+enum class randomStreamType : uint64_t {
+	GAMEPLAY = 1, SPAWN, COSMETIC
+};
+
+// PCG32: small, fast, and the same sequence on every compiler, which std::rand() and the
+// std distributions do not promise. Every subsystem draws from its own stream, so drawing
+// one more shake does not move where the next enemy comes out.
+class RandomStream
+{
+public:
+	void seed(uint64_t seedValue, randomStreamType stream)
+	{
+		state = 0;
+		increment = (uint64_t(stream) << 1) | 1u;
+		nextUint();
+		state += seedValue;
+		nextUint();
+	}
+
+	uint32_t nextUint()
+	{
+		const uint64_t oldState = state;
+		state = oldState * 6364136223846793005ULL + increment;
+		const uint32_t xorShifted = uint32_t(((oldState >> 18) ^ oldState) >> 27);
+		const uint32_t rotation = uint32_t(oldState >> 59);
+		return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+	}
+
+	// [min, max), like doodle::random()
+	float nextFloat(float min, float max)
+	{
+		return min + (max - min) * float(nextUint() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// [min, max), min when the range is empty
+	int nextInt(int min, int max)
+	{
+		if (max <= min)
+			return min;
+		return min + int(nextUint() % uint32_t(max - min));
+	}
+
+private:
+	uint64_t state = 0;
+	uint64_t increment = 1;
+};
@@ -0,0 +1,238 @@
+﻿/*
+  render_queue.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "render_queue.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+using doodle::HexColor;
+
+
+
+namespace {
+
+	uint32_t toBits(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+}
+
+RenderQueue::RenderCommand& RenderQueue::push(renderLayer layer, primitiveType primitive, const RenderState& state)
+{
+	commands.emplace_back();
+	RenderCommand& command = commands.back();
+	command.state = state;
+	command.order = uint32_t(commands.size() - 1);
+	command.layer = layer;
+	command.primitive = primitive;
+
+	// the parts of the state doodle ignores should not split up a run of equal draws
+	if (!state.isOutlined) {
+		command.state.outline = HexColor{ defaultDrawOutline };
+		command.state.outlineWidth = defaultDrawOutlineWidth;
+	}
+	if (!state.isFilled || primitive == primitiveType::LINE) {
+		command.state.fill = HexColor{ defaultDrawFill };
+		command.state.isFilled = false;
+	}
+	return command;
+}
+
+void RenderQueue::drawEllipse(renderLayer layer, const RenderState& state, float x, float y, float width, float height)
+{
+	float* points = push(layer, primitiveType::ELLIPSE, state).points;
+	points[0] = x;
+	points[1] = y;
+	points[2] = width;
+	points[3] = height;
+}
+
+void RenderQueue::drawRectangle(renderLayer layer, const RenderState& state, float x, float y, float width, float height, float rotation)
+{
+	if (rotation == 0.0f) {
+		float* points = push(layer, primitiveType::RECTANGLE, state).points;
+		points[0] = x;
+		points[1] = y;
+		points[2] = width;
+		points[3] = height;
+		return;
+	}
+
+	// turned the way apply_rotate() would have, so it can go out without its own transform
+	const float c = std::cos(rotation);
+	const float s = std::sin(rotation);
+	const float halfWidth = width / 2;
+	const float halfHeight = height / 2;
+	const float cornerX[4] = { x - halfWidth, x + halfWidth, x + halfWidth, x - halfWidth };
+	const float cornerY[4] = { y - halfHeight, y - halfHeight, y + halfHeight, y + halfHeight };
+
+	float* points = push(layer, primitiveType::QUAD, state).points;
+	for (int i = 0; i < 4; i++) {
+		points[i * 2] = cornerX[i] * c - cornerY[i] * s;
+		points[i * 2 + 1] = cornerX[i] * s + cornerY[i] * c;
+	}
+}
+
+void RenderQueue::drawTriangle(renderLayer layer, const RenderState& state, float x1, float y1, float x2, float y2, float x3, float y3)
+{
+	float* points = push(layer, primitiveType::TRIANGLE, state).points;
+	points[0] = x1;
+	points[1] = y1;
+	points[2] = x2;
+	points[3] = y2;
+	points[4] = x3;
+	points[5] = y3;
+}
+
+void RenderQueue::drawQuad(renderLayer layer, const RenderState& state, float x1, float y1, float x2, float y2,
+	float x3, float y3, float x4, float y4)
+{
+	float* points = push(layer, primitiveType::QUAD, state).points;
+	points[0] = x1;
+	points[1] = y1;
+	points[2] = x2;
+	points[3] = y2;
+	points[4] = x3;
+	points[5] = y3;
+	points[6] = x4;
+	points[7] = y4;
+}
+
+void RenderQueue::drawLine(renderLayer layer, const RenderState& state, float x1, float y1, float x2, float y2)
+{
+	float* points = push(layer, primitiveType::LINE, state).points;
+	points[0] = x1;
+	points[1] = y1;
+	points[2] = x2;
+	points[3] = y2;
+}
+
+// Brings doodle to the state of command and returns how many calls that took
+unsigned int RenderQueue::applyState(AppliedState& applied, const RenderCommand& command, Renderer* target)
+{
+	const RenderState& wanted = command.state;
+	RenderState& current = applied.state;
+	unsigned int changes = 0;
+
+	if (command.primitive != primitiveType::LINE &&
+		(!applied.isFillKnown || wanted.isFilled != current.isFilled || (wanted.isFilled && wanted.fill.rgba != current.fill.rgba))) {
+		if (target != nullptr) {
+			if (wanted.isFilled)
+				target->setFill(wanted.fill);
+			else
+				target->noFill();
+		}
+		current.isFilled = wanted.isFilled;
+		current.fill = wanted.fill;
+		applied.isFillKnown = true;
+		changes++;
+	}
+
+	if (!applied.isOutlineKnown || wanted.isOutlined != current.isOutlined) {
+		if (target != nullptr && !wanted.isOutlined)
+			target->noOutline();
+		current.isOutlined = wanted.isOutlined;
+		changes += wanted.isOutlined ? 0 : 1;
+		applied.isOutlineKnown = true;
+		if (wanted.isOutlined) {
+			// only set_outline_color() turns the outline back on, so it goes out again below
+			current.outline.rgba = ~wanted.outline.rgba;
+			current.outlineWidth = -1.0f;
+		}
+	}
+	if (wanted.isOutlined) {
+		if (wanted.outline.rgba != current.outline.rgba) {
+			if (target != nullptr)
+				target->setOutline(wanted.outline);
+			current.outline = wanted.outline;
+			changes++;
+		}
+		if (wanted.outlineWidth != current.outlineWidth) {
+			if (target != nullptr)
+				target->setOutlineWidth(wanted.outlineWidth);
+			current.outlineWidth = wanted.outlineWidth;
+			changes++;
+		}
+	}
+
+	return changes;
+}
+
+void RenderQueue::send(Renderer& target, const RenderCommand& command)
+{
+	const float* p = command.points;
+	switch (command.primitive) {
+	case primitiveType::ELLIPSE:
+		target.drawEllipse(p[0], p[1], p[2], p[3]);
+		break;
+	case primitiveType::RECTANGLE:
+		target.drawRectangle(p[0], p[1], p[2], p[3]);
+		break;
+	case primitiveType::TRIANGLE:
+		target.drawTriangle(p[0], p[1], p[2], p[3], p[4], p[5]);
+		break;
+	case primitiveType::QUAD:
+		target.drawQuad(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+		break;
+	case primitiveType::LINE:
+		target.drawLine(p[0], p[1], p[2], p[3]);
+		break;
+	}
+}
+
+void RenderQueue::flush(Renderer& target)
+{
+	PROFILE_SCOPE("RenderQueue::flush");
+
+	stats = RenderStats{};
+	stats.commands = unsigned(commands.size());
+	if (commands.empty())
+		return;
+
+	AppliedState unsorted;
+	for (const RenderCommand& command : commands)
+		stats.unsortedStateChanges += applyState(unsorted, command, nullptr);
+
+	sortedOrder.resize(commands.size());
+	for (uint32_t i = 0; i < sortedOrder.size(); i++)
+		sortedOrder[i] = i;
+
+	// outline first since lines only care about that, then fill, then the primitive;
+	// the submission order breaks ties so a frame always comes out the same
+	std::sort(sortedOrder.begin(), sortedOrder.end(), [this](uint32_t a, uint32_t b) {
+		const RenderCommand& left = commands[a];
+		const RenderCommand& right = commands[b];
+		return std::make_tuple(left.layer, left.state.isOutlined, left.state.outline.rgba, toBits(left.state.outlineWidth),
+			left.state.isFilled, left.state.fill.rgba, left.primitive, left.order) <
+			std::make_tuple(right.layer, right.state.isOutlined, right.state.outline.rgba, toBits(right.state.outlineWidth),
+			right.state.isFilled, right.state.fill.rgba, right.primitive, right.order);
+	});
+
+	target.pushSettings();
+	AppliedState applied;
+	for (uint32_t index : sortedOrder) {
+		const RenderCommand& command = commands[index];
+		stats.stateChanges += applyState(applied, command, &target);
+		send(target, command);
+		stats.drawCalls++;
+	}
+	target.popSettings();
+
+	commands.clear();
+}
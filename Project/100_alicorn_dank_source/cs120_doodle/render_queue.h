@@ -0,0 +1,99 @@
+﻿/*
+  render_queue.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <doodle/color.hpp>
+#include "renderer.h"
+#include <cstdint>
+#include <vector>
+
+
+
+// Layers are drawn in this order, whatever was submitted first. Inside a layer the
+// commands are free to be reordered, so only things that never overlap share one.
+enum class renderLayer : unsigned char {
+	ENEMY, INDICATOR, BEAM, CANNON, SIGHT, PLAYER
+};
+
+enum class primitiveType : unsigned char {
+	ELLIPSE, RECTANGLE, TRIANGLE, QUAD, LINE
+};
+
+// Everything one draw used to set between push_settings() and pop_settings()
+struct RenderState {
+	doodle::HexColor fill{ defaultDrawFill };
+	doodle::HexColor outline{ defaultDrawOutline };
+	float outlineWidth = defaultDrawOutlineWidth;
+	bool isFilled = true;
+	bool isOutlined = true;
+
+	RenderState& setFill(doodle::HexColor color) { fill = color; isFilled = true; return *this; }
+	RenderState& noFill() { isFilled = false; return *this; }
+	RenderState& setOutline(doodle::HexColor color, float width) { outline = color; outlineWidth = width; isOutlined = true; return *this; }
+	RenderState& noOutline() { isOutlined = false; return *this; }
+};
+
+struct RenderStats {
+	unsigned int commands = 0;
+	unsigned int drawCalls = 0;
+	unsigned int stateChanges = 0;
+	// what the same frame would have cost drawn in the order it was submitted
+	unsigned int unsortedStateChanges = 0;
+};
+
+// Gameplay code writes its draws in here during the frame instead of talking to doodle.
+// flush() sorts them by layer, state and primitive and sends them to the renderer with
+// only the state changes that are really needed, all inside a single pushSettings().
+class RenderQueue
+{
+public:
+	void drawEllipse(renderLayer layer, const RenderState& state, float x, float y, float width, float height = 0);
+	// rectangles are centered, as GamePlay sets them; rotation is around the origin like apply_rotate()
+	void drawRectangle(renderLayer layer, const RenderState& state, float x, float y, float width, float height, float rotation = 0.0f);
+	void drawTriangle(renderLayer layer, const RenderState& state, float x1, float y1, float x2, float y2, float x3, float y3);
+	void drawQuad(renderLayer layer, const RenderState& state, float x1, float y1, float x2, float y2,
+		float x3, float y3, float x4, float y4);
+	// a line only uses the outline of the state
+	void drawLine(renderLayer layer, const RenderState& state, float x1, float y1, float x2, float y2);
+
+	void flush(Renderer& target);
+
+	// counted by the last flush()
+	const RenderStats& getStats() const { return stats; }
+
+private:
+	struct RenderCommand {
+		RenderState state;
+		float points[8];
+		uint32_t order;
+		renderLayer layer;
+		primitiveType primitive;
+	};
+
+	// what doodle was last told, so nothing is sent twice
+	struct AppliedState {
+		bool isFillKnown = false;
+		bool isOutlineKnown = false;
+		RenderState state;
+	};
+
+	RenderCommand& push(renderLayer layer, primitiveType primitive, const RenderState& state);
+	// without a target it only counts
+	static unsigned int applyState(AppliedState& applied, const RenderCommand& command, Renderer* target);
+	static void send(Renderer& target, const RenderCommand& command);
+
+	std::vector<RenderCommand> commands;
+	std::vector<uint32_t> sortedOrder;
+	RenderStats stats;
+};
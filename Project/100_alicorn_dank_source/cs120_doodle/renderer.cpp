@@ -0,0 +1,161 @@
+﻿/*
+  renderer.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "renderer.h"
+#include <cstdio>
+
+using namespace doodle;
+
+
+
+namespace {
+
+	const char* renderCommandNames[] = { "modes", "push", "pop", "fill", "nofill", "outline", "nooutline", "width", "fontsize",
+		"ellipse", "rectangle", "triangle", "quad", "line", "text" };
+	static_assert(sizeof(renderCommandNames) / sizeof(renderCommandNames[0]) == int(renderCommandKind::COUNT),
+		"every command needs a name");
+
+}
+
+const char* getRenderCommandName(renderCommandKind kind)
+{
+	return renderCommandNames[int(kind)];
+}
+
+void DoodleRenderer::setShapeModes(EllipseMode ellipseMode, RectMode rectMode)
+{
+	set_frame_of_reference(RightHanded_OriginCenter);
+	set_ellipse_mode(ellipseMode);
+	set_rectangle_mode(rectMode);
+}
+
+void RecordingRenderer::beginFrame()
+{
+	frameText.clear();
+}
+
+void RecordingRenderer::endFrame()
+{
+	if (output != nullptr)
+		*output << "frame " << frameCount << "\n" << frameText;
+	frameCount++;
+}
+
+void RecordingRenderer::record(renderCommandKind kind, const float* values, int valueCount, const char* detail)
+{
+	commandCounts[int(kind)]++;
+	if (output == nullptr)
+		return;
+
+	frameText += renderCommandNames[int(kind)];
+	char number[32];
+	for (int i = 0; i < valueCount; i++) {
+		snprintf(number, sizeof(number), " %g", values[i]);
+		frameText += number;
+	}
+	if (detail != nullptr) {
+		frameText += ' ';
+		frameText += detail;
+	}
+	frameText += '\n';
+}
+
+// colors go out as hex so they read the same as in the source
+void RecordingRenderer::recordColor(renderCommandKind kind, HexColor color)
+{
+	char hex[16];
+	snprintf(hex, sizeof(hex), "%08x", color.rgba);
+	record(kind, nullptr, 0, hex);
+}
+
+void RecordingRenderer::setShapeModes(EllipseMode ellipseMode, RectMode rectMode)
+{
+	const float values[] = { float(ellipseMode), float(rectMode) };
+	record(renderCommandKind::SHAPE_MODES, values, 2);
+}
+
+void RecordingRenderer::pushSettings()
+{
+	record(renderCommandKind::PUSH, nullptr, 0);
+}
+
+void RecordingRenderer::popSettings()
+{
+	record(renderCommandKind::POP, nullptr, 0);
+}
+
+void RecordingRenderer::setFill(HexColor color)
+{
+	recordColor(renderCommandKind::FILL, color);
+}
+
+void RecordingRenderer::noFill()
+{
+	record(renderCommandKind::NO_FILL, nullptr, 0);
+}
+
+void RecordingRenderer::setOutline(HexColor color)
+{
+	recordColor(renderCommandKind::OUTLINE, color);
+}
+
+void RecordingRenderer::noOutline()
+{
+	record(renderCommandKind::NO_OUTLINE, nullptr, 0);
+}
+
+void RecordingRenderer::setOutlineWidth(float width)
+{
+	record(renderCommandKind::OUTLINE_WIDTH, &width, 1);
+}
+
+void RecordingRenderer::setFontSize(float size)
+{
+	record(renderCommandKind::FONT_SIZE, &size, 1);
+}
+
+void RecordingRenderer::drawEllipse(float x, float y, float width, float height)
+{
+	const float values[] = { x, y, width, height };
+	record(renderCommandKind::ELLIPSE, values, 4);
+}
+
+void RecordingRenderer::drawRectangle(float x, float y, float width, float height)
+{
+	const float values[] = { x, y, width, height };
+	record(renderCommandKind::RECTANGLE, values, 4);
+}
+
+void RecordingRenderer::drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+	const float values[] = { x1, y1, x2, y2, x3, y3 };
+	record(renderCommandKind::TRIANGLE, values, 6);
+}
+
+void RecordingRenderer::drawQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4)
+{
+	const float values[] = { x1, y1, x2, y2, x3, y3, x4, y4 };
+	record(renderCommandKind::QUAD, values, 8);
+}
+
+void RecordingRenderer::drawLine(float x1, float y1, float x2, float y2)
+{
+	const float values[] = { x1, y1, x2, y2 };
+	record(renderCommandKind::LINE, values, 4);
+}
+
+void RecordingRenderer::drawText(const std::string& text, float x, float y)
+{
+	const float values[] = { x, y };
+	record(renderCommandKind::TEXT, values, 2, text.c_str());
+}
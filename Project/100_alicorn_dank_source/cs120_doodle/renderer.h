@@ -0,0 +1,152 @@
+﻿/*
+  renderer.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <doodle/color.hpp>
+#include <doodle/drawing.hpp>
+#include <ostream>
+#include <string>
+
+
+
+// What doodle starts with, and what a draw gets when it only sets part of its state
+constexpr unsigned int defaultDrawFill = 0xFFFFFFFF;
+constexpr unsigned int defaultDrawOutline = 0x000000FF;
+constexpr float defaultDrawOutlineWidth = 1.0f;
+
+// What the gameplay drawing targets instead of the doodle functions, so the same frame
+// can go to the window, nowhere, or into a text log. Mirrors the doodle calls it replaces.
+class Renderer {
+public:
+	virtual ~Renderer() {}
+
+	virtual void beginFrame() {}
+	virtual void endFrame() {}
+
+	// RightHanded_OriginCenter with the given ellipse and rectangle modes
+	virtual void setShapeModes(doodle::EllipseMode ellipseMode, doodle::RectMode rectMode) = 0;
+
+	virtual void pushSettings() = 0;
+	virtual void popSettings() = 0;
+	virtual void setFill(doodle::HexColor color) = 0;
+	virtual void noFill() = 0;
+	virtual void setOutline(doodle::HexColor color) = 0;
+	virtual void noOutline() = 0;
+	virtual void setOutlineWidth(float width) = 0;
+	virtual void setFontSize(float size) = 0;
+
+	virtual void drawEllipse(float x, float y, float width, float height) = 0;
+	virtual void drawRectangle(float x, float y, float width, float height) = 0;
+	virtual void drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3) = 0;
+	virtual void drawQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) = 0;
+	virtual void drawLine(float x1, float y1, float x2, float y2) = 0;
+	virtual void drawText(const std::string& text, float x, float y) = 0;
+};
+
+// The window, what the game always drew to
+class DoodleRenderer : public Renderer {
+public:
+	void setShapeModes(doodle::EllipseMode ellipseMode, doodle::RectMode rectMode) override;
+
+	void pushSettings() override { doodle::push_settings(); }
+	void popSettings() override { doodle::pop_settings(); }
+	void setFill(doodle::HexColor color) override { doodle::set_fill_color(color); }
+	void noFill() override { doodle::no_fill(); }
+	void setOutline(doodle::HexColor color) override { doodle::set_outline_color(color); }
+	void noOutline() override { doodle::no_outline(); }
+	void setOutlineWidth(float width) override { doodle::set_outline_width(width); }
+	void setFontSize(float size) override { doodle::set_font_size(size); }
+
+	void drawEllipse(float x, float y, float width, float height) override { doodle::draw_ellipse(x, y, width, height); }
+	void drawRectangle(float x, float y, float width, float height) override { doodle::draw_rectangle(x, y, width, height); }
+	void drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3) override { doodle::draw_triangle(x1, y1, x2, y2, x3, y3); }
+	void drawQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) override
+	{
+		doodle::draw_quad(x1, y1, x2, y2, x3, y3, x4, y4);
+	}
+	void drawLine(float x1, float y1, float x2, float y2) override { doodle::draw_line(x1, y1, x2, y2); }
+	void drawText(const std::string& text, float x, float y) override { doodle::draw_text(text, x, y); }
+};
+
+// Throws every frame away, for timing the game without a window
+class NullRenderer : public Renderer {
+public:
+	void setShapeModes(doodle::EllipseMode, doodle::RectMode) override {}
+
+	void pushSettings() override {}
+	void popSettings() override {}
+	void setFill(doodle::HexColor) override {}
+	void noFill() override {}
+	void setOutline(doodle::HexColor) override {}
+	void noOutline() override {}
+	void setOutlineWidth(float) override {}
+	void setFontSize(float) override {}
+
+	void drawEllipse(float, float, float, float) override {}
+	void drawRectangle(float, float, float, float) override {}
+	void drawTriangle(float, float, float, float, float, float) override {}
+	void drawQuad(float, float, float, float, float, float, float, float) override {}
+	void drawLine(float, float, float, float) override {}
+	void drawText(const std::string&, float, float) override {}
+};
+
+enum class renderCommandKind {
+	SHAPE_MODES, PUSH, POP, FILL, NO_FILL, OUTLINE, NO_OUTLINE, OUTLINE_WIDTH, FONT_SIZE,
+	ELLIPSE, RECTANGLE, TRIANGLE, QUAD, LINE, TEXT, COUNT
+};
+
+const char* getRenderCommandName(renderCommandKind kind);
+
+// Writes each frame's commands as text, one per line, so two versions of the game can be
+// diffed or just have their counts compared. Without a stream it only counts.
+// A line is the command name, its numbers, then a hex color or the rest of the text.
+class RecordingRenderer : public Renderer {
+public:
+	explicit RecordingRenderer(std::ostream* newOutput = nullptr) : output(newOutput) {}
+
+	void beginFrame() override;
+	void endFrame() override;
+
+	void setShapeModes(doodle::EllipseMode ellipseMode, doodle::RectMode rectMode) override;
+
+	void pushSettings() override;
+	void popSettings() override;
+	void setFill(doodle::HexColor color) override;
+	void noFill() override;
+	void setOutline(doodle::HexColor color) override;
+	void noOutline() override;
+	void setOutlineWidth(float width) override;
+	void setFontSize(float size) override;
+
+	void drawEllipse(float x, float y, float width, float height) override;
+	void drawRectangle(float x, float y, float width, float height) override;
+	void drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3) override;
+	void drawQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) override;
+	void drawLine(float x1, float y1, float x2, float y2) override;
+	void drawText(const std::string& text, float x, float y) override;
+
+	unsigned int getFrameCount() const { return frameCount; }
+	// over every recorded frame
+	unsigned long long getCommandCount(renderCommandKind kind) const { return commandCounts[int(kind)]; }
+
+private:
+	// detail goes at the end of the line, after the numbers
+	void record(renderCommandKind kind, const float* values, int valueCount, const char* detail = nullptr);
+	void recordColor(renderCommandKind kind, doodle::HexColor color);
+
+	std::ostream* output;
+	std::string frameText;
+	unsigned int frameCount = 0;
+	unsigned long long commandCounts[int(renderCommandKind::COUNT)] = {};
+};
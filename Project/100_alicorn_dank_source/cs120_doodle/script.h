@@ -13,18 +13,16 @@
 
 #pragma once
 
+#include "wave_format.h"
 
 
-void GetStringParam(char* pstrDestString);
 
-int GetIntParam(void);
+// Maps the compiled form of the text script (same name, .waves), compiling it first
+// if it is missing or older than the text. Cheap to call again once loaded.
+bool LoadScript(const char* pstrFilename);
 
-int CompareCommand(char* pstrDestString);
-
-void GetCommand(char* pstrDestString);
+// Spawn lines of one wave, straight out of the mapped file. count is 0 for a wave the
+// script does not define.
+const SpawnRecord* GetScriptWave(unsigned int wave, size_t& count);
 
 void UnloadScript(void);
-
-void RunScript(void);
-
-void LoadScript(const char* pstrFilename);
\ No newline at end of file
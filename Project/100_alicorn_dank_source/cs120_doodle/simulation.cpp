@@ -0,0 +1,421 @@
+﻿/*
+  simulation.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "simulation.h"
+#include "classes.h"
+#include "script.h"
+#include "profiler.h"
+#include "variables.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+
+
+void Simulation::setup()
+{
+	clear();
+	customWave.clear();
+
+	playerList.push_back(new player({ 0.0f, 0.0f }));
+	playerList.back()->addModule(new Wheel());
+	playerList.back()->addModule(new Eye());
+	playerList.back()->addModule(new Ear());
+	playerList.back()->addModule(new Cannon());
+
+	//before actual gameplay starts, initialize gameWave to 1
+	gameWave = 1;
+
+	//Load Enemy Info
+	LoadScript("scripts/script.txt");
+
+	beginSession();
+}
+
+void Simulation::setupWave(const SpawnRecord* spawns, size_t count)
+{
+	clear();
+	customWave.assign(spawns, spawns + count);
+
+	playerList.push_back(new player({ 0.0f, 0.0f }));
+
+	gameWave = 1;
+	enemyList.resize(size_t(maxWave) + 1); // what LoadScript() would have done
+
+	beginSession();
+}
+
+void Simulation::beginSession()
+{
+	if (!isSeedFixed) {
+		std::random_device device;
+		seed = (uint64_t(device()) << 32) | device();
+	}
+	gameplayRandom.seed(seed, randomStreamType::GAMEPLAY);
+	spawnRandom.seed(seed, randomStreamType::SPAWN);
+	cosmeticRandom.seed(seed, randomStreamType::COSMETIC);
+
+	if (!recordingPath.empty()) {
+		inputLog.clear(seed);
+		isSessionRecorded = true;
+	}
+
+	// keys held from before the session only count once pressed again
+	pendingInput.clear();
+	pendingInput.reserve(InputQueue::capacity);
+	pendingCursor = 0;
+	unplacedInput = 0;
+	heldKeys = 0;
+	tickInput = TickInput();
+	fireReleaseTime = 0.0;
+
+	time = 0.0f;
+	accumulator = 0.0f;
+	tickCount = 0;
+	soundEvents.clear();
+	scheduler.setCurrentTick(0);
+
+	startWave();
+}
+
+void Simulation::clear()
+{
+	// the checksum needs everything still there
+	if (isSessionRecorded)
+		saveRecording();
+
+	enemyGrid.clear();
+	destroyedEnemyList.clear(); // still in their storage, deleted below
+
+	scheduler.clear();
+	pendingSpawnCount = 0;
+
+	for (EnemyStorage& storage : enemyList) {
+		for (enemy* enemyInst : storage)
+			delete enemyInst;
+	}
+	for (player* playerInst : playerList)
+		delete playerInst;
+
+	enemyList.clear();
+	playerList.clear();
+}
+
+int Simulation::advance(float frameDeltaTime)
+{
+	soundEvents.clear();
+
+	accumulator += frameDeltaTime;
+
+	// the frame began at time + accumulator, the input queued for it came in before that
+	const float frameStart = time + accumulator;
+	for (size_t i = unplacedInput; i < pendingInput.size(); i++)
+		pendingInput[i].time = frameStart - float(queuedFrameTime - pendingInput[i].event.time);
+	unplacedInput = pendingInput.size();
+
+	int ticks = 0;
+	while (accumulator >= simulationDeltaTime && ticks < maxTicksPerFrame) {
+		tick();
+		accumulator -= simulationDeltaTime;
+		ticks++;
+	}
+
+	if (ticks == maxTicksPerFrame && accumulator > simulationDeltaTime)
+		accumulator = simulationDeltaTime;
+
+	return ticks;
+}
+
+void Simulation::tick()
+{
+	PROFILE_SCOPE("Simulation::tick");
+
+	globalDeltaTime = simulationDeltaTime;
+
+	tickInput = (playback != nullptr) ? playback->next() : takeInput();
+	if (isSessionRecorded)
+		inputLog.record(tickCount, tickInput);
+	applyInput(tickInput);
+
+	updateWave();
+
+	enemy::updateAll(enemyList[gameWave]);
+
+	scheduler.runDue(tickCount, [this](const ScheduledEvent& event) { runEvent(event); });
+
+	for (player* instPlayer : playerList)
+		instPlayer->update();
+
+	flushDestroyedEnemies();
+
+	time += simulationDeltaTime;
+	tickCount++;
+}
+
+void Simulation::updateWave()
+{
+	if (enemyList[gameWave].size() == 0 && pendingSpawnCount == 0) {
+		if (gameWave < maxWave) // the last wave keeps coming back
+			gameWave++;
+
+		startWave();
+	}
+}
+
+// Schedules a SPAWN for every line of the wave. Nothing is built until it comes out.
+void Simulation::startWave()
+{
+	PROFILE_SCOPE("Simulation::startWave");
+
+	// every enemy of the last wave is gone, so are the events that could still name one
+	scheduler.clear();
+
+	size_t spawnCount = customWave.size();
+	const SpawnRecord* spawns = customWave.data();
+	if (customWave.empty())
+		spawns = GetScriptWave(gameWave, spawnCount);
+	for (size_t i = 0; i < spawnCount; i++)
+		scheduleSpawn(spawns[i]);
+	pendingSpawnCount = (unsigned int)spawnCount;
+}
+
+void Simulation::schedule(float delay, scheduledEventType type, const SlotHandle& enemyHandle)
+{
+	ScheduledEvent event;
+	event.tick = tickCount + (unsigned int)ceilf(delay * simulationTickRate);
+	event.type = type;
+	event.enemyHandle = enemyHandle;
+	scheduler.schedule(event);
+}
+
+void Simulation::scheduleSpawn(const SpawnRecord& spawn)
+{
+	ScheduledEvent event;
+	event.tick = tickCount + (unsigned int)ceilf(spawn.startTime * simulationTickRate);
+	event.type = scheduledEventType::SPAWN;
+	event.spawn = spawn;
+	scheduler.schedule(event);
+}
+
+void Simulation::runEvent(const ScheduledEvent& event)
+{
+	if (event.type == scheduledEventType::SPAWN) {
+		PROFILE_SCOPE("enemyEmergence");
+		const Vector pos = toVector(static_cast<directionType>(event.spawn.direction));
+		enemy* newEnemy = new enemy(pos, circleFlag, static_cast<enemyType>(event.spawn.type));
+		newEnemy->spawnInto(enemyList[gameWave]);
+		pendingSpawnCount--;
+		return;
+	}
+
+	enemy::runScheduledEvent(enemyList[gameWave], event);
+}
+
+bool Simulation::isPlayerDead() const
+{
+	for (player* instPlayer : playerList) {
+		if (instPlayer->getLife() <= 0)
+			return true;
+	}
+	return false;
+}
+
+void Simulation::queueInput(const std::vector<InputEvent>& events, double frameTime)
+{
+	for (const InputEvent& event : events) {
+		PendingInput input;
+		input.event = event;
+		pendingInput.push_back(input);
+	}
+	queuedFrameTime = frameTime;
+}
+
+// Plays this tick's share of the queued events into heldKeys, timing how long fire was down
+TickInput Simulation::takeInput()
+{
+	static_assert((1u << unsigned(inputKey::FIRE)) == inputFlag::fire, "inputKey and inputFlag have to line up");
+
+	const float tickStart = time;
+	const float tickEnd = time + simulationDeltaTime;
+
+	bool isFireDown = (heldKeys & inputFlag::fire) != 0;
+	float fireDownSince = tickStart;
+	float fireHeldTime = 0.0f;
+
+	while (pendingCursor < unplacedInput && pendingInput[pendingCursor].time < tickEnd) {
+		const PendingInput& input = pendingInput[pendingCursor++];
+		if (input.event.key > inputKey::FIRE)
+			continue;
+
+		const float eventTime = (input.time > tickStart) ? input.time : tickStart; // late frames pile up at the start
+		if (input.event.key == inputKey::FIRE && input.event.isPressed != isFireDown) {
+			if (isFireDown) {
+				fireHeldTime += eventTime - fireDownSince;
+				fireReleaseTime = input.event.time;
+			}
+			else
+				fireDownSince = eventTime;
+			isFireDown = input.event.isPressed;
+		}
+
+		const unsigned char flag = (unsigned char)(1u << unsigned(input.event.key));
+		heldKeys = input.event.isPressed ? (unsigned char)(heldKeys | flag) : (unsigned char)(heldKeys & ~flag);
+	}
+	if (isFireDown)
+		fireHeldTime += tickEnd - fireDownSince;
+
+	if (pendingCursor == pendingInput.size()) {
+		pendingInput.clear();
+		pendingCursor = 0;
+		unplacedInput = 0;
+	}
+
+	TickInput input;
+	input.keys = heldKeys;
+	if (isProjectionOverlayed)
+		input.keys |= inputFlag::overlay;
+	const long fireHeld = lroundf(fireHeldTime / simulationDeltaTime * fullTick);
+	input.fireHeld = (unsigned short)((fireHeld < 0) ? 0 : (fireHeld > fullTick) ? fullTick : fireHeld);
+	return input;
+}
+
+void Simulation::noteShot()
+{
+	// a shot the overlay closing let go, or a replay, has no release to measure from
+	if (fireReleaseTime <= 0.0)
+		return;
+
+	const float latencyMs = float((InputQueue::now() - fireReleaseTime) * 1000.0);
+	fireReleaseTime = 0.0;
+
+	inputLatency.lastMs = latencyMs;
+	inputLatency.averageMs = (inputLatency.shots == 0) ? latencyMs : lerp(inputLatency.averageMs, latencyMs, 0.1f);
+	inputLatency.shots++;
+}
+
+uint32_t Simulation::getChecksum() const
+{
+	// FNV-1a over the raw bytes, floats included; a replay runs the same code on the same inputs
+	uint32_t hash = 2166136261u;
+	auto mix = [&hash](const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+	};
+
+	mix(&tickCount, sizeof(tickCount));
+	mix(&gameWave, sizeof(gameWave));
+	for (player* instPlayer : playerList) {
+		const Vector pos = instPlayer->getPos2D();
+		const int life = instPlayer->getLife();
+		mix(&pos, sizeof(pos));
+		mix(&life, sizeof(life));
+	}
+
+	if (gameWave < enemyList.size()) {
+		// the projection is there for the player's rotation
+		const EnemyStorage& enemies = enemyList[gameWave];
+		mix(enemies.posX.data(), enemies.posX.size() * sizeof(float));
+		mix(enemies.posY.data(), enemies.posY.size() * sizeof(float));
+		mix(enemies.projectedX.data(), enemies.projectedX.size() * sizeof(float));
+		mix(enemies.projectedY.data(), enemies.projectedY.size() * sizeof(float));
+		mix(enemies.flags.data(), enemies.flags.size());
+	}
+	return hash;
+}
+
+void Simulation::startRecording(const char* path)
+{
+	recordingPath = path;
+}
+
+void Simulation::stopRecording()
+{
+	if (isSessionRecorded)
+		saveRecording();
+	recordingPath.clear();
+}
+
+void Simulation::saveRecording()
+{
+	isSessionRecorded = false;
+	inputLog.finish(tickCount, getChecksum());
+	if (!inputLog.save(recordingPath.c_str()))
+		std::cout << "could not save the input log to " << recordingPath << "\n";
+}
+
+void flushDestroyedEnemies()
+{
+	for (enemy* enemyInst : destroyedEnemyList) {
+		enemyList[gameWave].erase(enemyInst->getHandle());
+		delete enemyInst;
+	}
+	destroyedEnemyList.clear();
+}
+
+int runHeadless(int ticks)
+{
+	simulation.setup();
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	int restarts = 0;
+	for (int i = 0; i < ticks; i++) {
+		simulation.advance(simulationDeltaTime);
+
+		// nobody is pressing anything, so the player eventually loses; just start over
+		if (simulation.isPlayerDead()) {
+			simulation.setup();
+			restarts++;
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+	std::cout << ticks << " ticks in " << elapsed.count() << " s ("
+		<< ticks / elapsed.count() << " ticks/s, " << restarts << " restarts)\n";
+
+	simulation.clear();
+	return 0;
+}
+
+int runReplay(const char* path)
+{
+	InputLog log;
+	if (!log.load(path)) {
+		std::cout << "could not read the input log " << path << "\n";
+		return 1;
+	}
+
+	InputLog::Reader reader(log);
+	simulation.setSeed(log.getSeed());
+	simulation.setPlayback(&reader);
+	simulation.setup();
+
+	auto startTime = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < log.getTickCount(); i++)
+		simulation.tick();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+	const bool isMatching = simulation.getChecksum() == log.getChecksum();
+	std::cout << log.getTickCount() << " ticks replayed in " << elapsed.count() << " s ("
+		<< log.getTickCount() / elapsed.count() / simulationTickRate << "x real time), "
+		<< log.getByteSize() << " bytes of input, checksum " << (isMatching ? "matches" : "differs") << "\n";
+
+	simulation.setPlayback(nullptr);
+	simulation.clear();
+	return isMatching ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+﻿/*
+  simulation.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "event_scheduler.h"
+#include "input_log.h"
+#include "input_queue.h"
+#include "slot_map.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+class player;
+class enemy;
+
+constexpr int simulationTickRate = 60;
+constexpr float simulationDeltaTime = 1.0f / simulationTickRate;
+constexpr int maxTicksPerFrame = 10; // a frame longer than this drops time instead of spiralling
+
+enum class soundEventType {
+	ENEMY_BLINK, ENEMY_DYING, PLAYER_HIT
+};
+
+// The simulation never touches the audio device, it leaves these for GamePlay to play
+struct SoundEvent {
+	soundEventType type;
+	unsigned int wave = 0;
+	SlotHandle enemyHandle;
+	player* playerPtr = nullptr;
+	float time = 0.0f; // simulation time of the tick it happened on, set by queueSound()
+};
+
+// From a fire key release to the shot it lets go, as the game ran it
+struct InputLatencyStats {
+	float lastMs = 0.0f;
+	float averageMs = 0.0f;
+	unsigned int shots = 0;
+};
+
+// Enemy, player, module and wave logic stepped at a fixed tick rate, without a window or audio.
+// GamePlay feeds it the frame time, then draws the result interpolated between the last two ticks.
+class Simulation {
+public:
+	void setup();
+	// Like setup(), but the player has no modules and every wave is spawns instead of the
+	// script. For benchmarks that build their own waves and drive the modules themselves.
+	void setupWave(const SpawnRecord* spawns, size_t count);
+	void clear();
+
+	int advance(float frameDeltaTime); // runs as many whole ticks as fit, returns how many
+	void tick();
+
+	// Key events of the frame about to advance(), each lands in the tick its time falls in.
+	// frameTime is when the frame began, on the same clock.
+	void queueInput(const std::vector<InputEvent>& events, double frameTime);
+	// seconds of the current tick the fire key was down, a tap shorter than a tick included
+	float getFireHeldTime() const { return float(tickInput.fireHeld) * simulationDeltaTime / fullTick; }
+	// the cannon just fired
+	void noteShot();
+	const InputLatencyStats& getInputLatency() const { return inputLatency; }
+
+	float getTime() const { return time; }
+	unsigned int getTickCount() const { return tickCount; }
+	float getInterpolation() const { return accumulator / simulationDeltaTime; }
+
+	bool isPlayerDead() const;
+
+	// hash of the player and enemy state, the same for every run of the same ticks
+	uint32_t getChecksum() const;
+
+	// From the next setup() on, every session logs its input and is saved into path when
+	// it ends, each one overwriting the last. See runReplay().
+	void startRecording(const char* path);
+	void stopRecording(); // saves the session in progress
+	// ticks take their input from reader instead of the keyboard, nullptr to stop
+	void setPlayback(InputLog::Reader* reader) { playback = reader; }
+
+	// the RNG streams of every following setup() start from this instead of a fresh seed
+	void setSeed(uint64_t newSeed) { seed = newSeed; isSeedFixed = true; }
+	uint64_t getSeed() const { return seed; }
+
+	void queueSound(SoundEvent event) { event.time = time; soundEvents.push_back(event); }
+	const std::vector<SoundEvent>& getSoundEvents() const { return soundEvents; }
+
+	// fires on the first tick at least delay seconds from now
+	void schedule(float delay, scheduledEventType type, const SlotHandle& enemyHandle);
+	void scheduleSpawn(const SpawnRecord& spawn);
+	size_t getScheduledEventCount() const { return scheduler.size(); }
+
+private:
+	void beginSession();
+	void saveRecording();
+	TickInput takeInput();
+	void updateWave();
+	void startWave();
+	void runEvent(const ScheduledEvent& event);
+
+	float time = 0.0f;
+	float accumulator = 0.0f;
+	unsigned int tickCount = 0;
+
+	std::vector<SoundEvent> soundEvents;
+
+	EventScheduler scheduler;
+	unsigned int pendingSpawnCount = 0;
+
+	std::vector<SpawnRecord> customWave; // played instead of the script when not empty
+
+	struct PendingInput {
+		InputEvent event;
+		float time = 0.0f; // simulation time, set once advance() knows where the frame starts
+	};
+	std::vector<PendingInput> pendingInput;
+	size_t pendingCursor = 0;  // the ones before it are taken
+	size_t unplacedInput = 0;  // the ones from it on have no simulation time yet
+	double queuedFrameTime = 0.0;
+	unsigned char heldKeys = 0;
+	TickInput tickInput;
+	double fireReleaseTime = 0.0; // of the release the next shot answers, 0 when none
+	InputLatencyStats inputLatency;
+
+	uint64_t seed = 0;
+	bool isSeedFixed = false;
+
+	InputLog inputLog;
+	std::string recordingPath;
+	bool isSessionRecorded = false; // logging since beginSession(), not saved yet
+	InputLog::Reader* playback = nullptr;
+};
+
+void flushDestroyedEnemies();
+
+int runHeadless(int ticks);
+// Plays a session saved by startRecording() back without a window, as fast as it goes,
+// and fails if it does not end on the recorded checksum
+int runReplay(const char* path);
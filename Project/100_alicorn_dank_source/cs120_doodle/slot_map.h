@@ -0,0 +1,154 @@
+﻿/*
+  slot_map.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+
+// Stable reference into a SlotMap. The generation is bumped every time a slot is
+// reused, so a handle to something that was erased never resolves to its successor.
+struct SlotHandle {
+	static constexpr unsigned int invalidIndex = 0xFFFFFFFF;
+
+	unsigned int index = invalidIndex;
+	unsigned int generation = 0;
+
+	bool isValid() const { return index != invalidIndex; }
+	bool operator==(const SlotHandle& handle) const { return index == handle.index && generation == handle.generation; }
+	bool operator!=(const SlotHandle& handle) const { return !(*this == handle); }
+};
+
+// Dense array with O(1) insert / erase / lookup through generational handles.
+// Values are kept packed so iterating is a plain walk over a vector; erasing
+// moves the last value into the hole, so iteration order is not stable.
+template<typename T>
+class SlotMap
+{
+public:
+	SlotHandle insert(const T& value)
+	{
+		unsigned int slotIndex;
+		if (!freeSlots.empty())
+		{
+			slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = static_cast<unsigned int>(slots.size());
+			slots.push_back(Slot{});
+		}
+
+		Slot& slot = slots[slotIndex];
+		slot.denseIndex = static_cast<unsigned int>(dense.size());
+
+		dense.push_back(value);
+		denseToSlot.push_back(slotIndex);
+
+		return SlotHandle{ slotIndex, slot.generation };
+	}
+
+	bool erase(const SlotHandle& handle)
+	{
+		if (!contains(handle))
+			return false;
+
+		Slot& slot = slots[handle.index];
+		const unsigned int hole = slot.denseIndex;
+		const unsigned int last = static_cast<unsigned int>(dense.size() - 1);
+
+		if (hole != last)
+		{
+			dense[hole] = dense[last];
+			denseToSlot[hole] = denseToSlot[last];
+			slots[denseToSlot[hole]].denseIndex = hole;
+		}
+		dense.pop_back();
+		denseToSlot.pop_back();
+
+		slot.generation++;
+		slot.denseIndex = SlotHandle::invalidIndex;
+		freeSlots.push_back(handle.index);
+		return true;
+	}
+
+	bool contains(const SlotHandle& handle) const
+	{
+		return handle.index < slots.size() &&
+			slots[handle.index].generation == handle.generation &&
+			slots[handle.index].denseIndex != SlotHandle::invalidIndex;
+	}
+
+	// dense position of a live handle, only valid until the next erase
+	size_t indexOf(const SlotHandle& handle) const
+	{
+		return slots[handle.index].denseIndex;
+	}
+
+	SlotHandle handleAt(size_t denseIndex) const
+	{
+		const unsigned int slotIndex = denseToSlot[denseIndex];
+		return SlotHandle{ slotIndex, slots[slotIndex].generation };
+	}
+
+	T* get(const SlotHandle& handle)
+	{
+		if (!contains(handle))
+			return nullptr;
+		return &dense[slots[handle.index].denseIndex];
+	}
+
+	void clear()
+	{
+		for (unsigned int slotIndex : denseToSlot)
+		{
+			slots[slotIndex].generation++;
+			slots[slotIndex].denseIndex = SlotHandle::invalidIndex;
+			freeSlots.push_back(slotIndex);
+		}
+		dense.clear();
+		denseToSlot.clear();
+	}
+
+	void reserve(size_t count)
+	{
+		dense.reserve(count);
+		denseToSlot.reserve(count);
+		slots.reserve(count);
+	}
+
+	size_t size() const { return dense.size(); }
+	bool empty() const { return dense.empty(); }
+
+	T& operator[](size_t denseIndex) { return dense[denseIndex]; }
+	const T& operator[](size_t denseIndex) const { return dense[denseIndex]; }
+
+	typename std::vector<T>::iterator begin() { return dense.begin(); }
+	typename std::vector<T>::iterator end() { return dense.end(); }
+	typename std::vector<T>::const_iterator begin() const { return dense.begin(); }
+	typename std::vector<T>::const_iterator end() const { return dense.end(); }
+
+private:
+	struct Slot {
+		unsigned int denseIndex = SlotHandle::invalidIndex;
+		unsigned int generation = 0;
+	};
+
+	std::vector<T> dense;
+	std::vector<unsigned int> denseToSlot;
+	std::vector<Slot> slots;
+	std::vector<unsigned int> freeSlots;
+};
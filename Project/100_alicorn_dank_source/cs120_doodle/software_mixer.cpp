@@ -0,0 +1,306 @@
+﻿/*
+  software_mixer.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "software_mixer.h"
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MIXER_SSE 1
+#include <emmintrin.h>
+#else
+#define MIXER_SSE 0
+#endif
+
+
+
+namespace {
+
+	// Mono source at the output rate, the common case, four frames at a time
+	void mixMono(const sf::Int16* source, size_t frames, float leftGain, float rightGain, float* out)
+	{
+		size_t i = 0;
+#if MIXER_SSE
+		const __m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+		for (; i + 4 <= frames; i += 4) {
+			// 4 samples -> 4 floats, each duplicated into a left/right pair
+			const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+			const __m128 samples = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+			const __m128 low = _mm_unpacklo_ps(samples, samples);
+			const __m128 high = _mm_unpackhi_ps(samples, samples);
+
+			float* target = out + i * 2;
+			_mm_storeu_ps(target, _mm_add_ps(_mm_loadu_ps(target), _mm_mul_ps(low, gains)));
+			_mm_storeu_ps(target + 4, _mm_add_ps(_mm_loadu_ps(target + 4), _mm_mul_ps(high, gains)));
+		}
+#endif
+		for (; i < frames; i++) {
+			const float sample = source[i];
+			out[i * 2] += sample * leftGain;
+			out[i * 2 + 1] += sample * rightGain;
+		}
+	}
+
+	// Everything else: stereo sources, other sample rates, linear interpolation
+	double mixResampled(const sf::Int16* source, uint32_t frameCount, uint16_t channelCount, bool loop,
+		double position, double step, size_t frames, float leftGain, float rightGain, float* out)
+	{
+		for (size_t i = 0; i < frames; i++) {
+			if (position >= frameCount) {
+				if (!loop)
+					break;
+				position = std::fmod(position, double(frameCount));
+			}
+
+			const uint32_t index = uint32_t(position);
+			const uint32_t next = (index + 1 < frameCount) ? index + 1 : (loop ? 0 : index);
+			const float blend = float(position - index);
+
+			float left, right;
+			if (channelCount == 1) {
+				left = right = source[index] + (source[next] - source[index]) * blend;
+			}
+			else {
+				left = source[index * 2] + (source[next * 2] - source[index * 2]) * blend;
+				right = source[index * 2 + 1] + (source[next * 2 + 1] - source[index * 2 + 1]) * blend;
+			}
+			out[i * 2] += left * leftGain;
+			out[i * 2 + 1] += right * rightGain;
+			position += step;
+		}
+		return position;
+	}
+
+	void toSamples(const float* mix, size_t count, sf::Int16* out)
+	{
+		size_t i = 0;
+#if MIXER_SSE
+		// the pack saturates, so loud moments clip instead of wrapping around
+		for (; i + 8 <= count; i += 8) {
+			const __m128i low = _mm_cvtps_epi32(_mm_loadu_ps(mix + i));
+			const __m128i high = _mm_cvtps_epi32(_mm_loadu_ps(mix + i + 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(low, high));
+		}
+#endif
+		for (; i < count; i++)
+			out[i] = sf::Int16(std::clamp(std::lround(mix[i]), -32768L, 32767L));
+	}
+}
+
+SoftwareMixer::SoftwareMixer(bool isBinaural)
+{
+	static_assert(blockFrames % hrtfPartitionSize == 0, "the HRTF convolution works in whole partitions");
+
+	voices.resize(maxVoices);
+	playing.reserve(maxVoices);
+	mixBuffer.resize(blockFrames * 2);
+	outputBuffer.resize(blockFrames * 2);
+
+	if (isBinaural) {
+		hrtf = std::make_unique<HrtfSet>();
+		isHrtfMeasured = hrtf->load(hrtfDataPath, outputRate);
+		if (!isHrtfMeasured)
+			hrtf->makeSphericalHead(outputRate);
+		hrtfRenderer = std::make_unique<BinauralRenderer>(*hrtf);
+		dryBuffer.resize(blockFrames * 2);
+		dryMono.resize(blockFrames);
+	}
+
+	initialize(2, outputRate);
+}
+
+SoftwareMixer::~SoftwareMixer()
+{
+	// the stream thread calls back into us, it has to be gone before the members are
+	stop();
+}
+
+bool SoftwareMixer::post(const MixerCommand& command)
+{
+	return commands.push(command);
+}
+
+void SoftwareMixer::runCommands()
+{
+	MixerCommand command;
+	while (commands.pop(command)) {
+		switch (command.type) {
+		case mixerCommandType::PLAY: {
+			if (command.slot >= maxVoices || command.samples == nullptr || command.frameCount == 0)
+				break;
+			MixVoice* voice = &voices[command.slot];
+			if (!voice->isPlaying) {
+				voice->isPlaying = true;
+				voice->playingIndex = uint32_t(playing.size());
+				playing.push_back(command.slot);
+			}
+			voice->binaural.reset();
+			voice->samples = command.samples;
+			voice->frameCount = command.frameCount;
+			voice->channelCount = command.channelCount;
+			voice->loop = command.loop;
+			voice->isRelative = command.isRelative;
+			voice->position = 0.0;
+			voice->step = double(command.sampleRate) / outputRate;
+			voice->startFrame = command.startFrame;
+			voice->x = command.x;
+			voice->z = command.z;
+			break;
+		}
+		case mixerCommandType::STOP: {
+			if (command.slot < maxVoices)
+				stopVoice(command.slot);
+			break;
+		}
+		case mixerCommandType::POSITION: {
+			if (command.slot < maxVoices) {
+				voices[command.slot].x = command.x;
+				voices[command.slot].z = command.z;
+			}
+			break;
+		}
+		case mixerCommandType::DISTANCE_MODEL: {
+			minDistance = command.x;
+			attenuation = command.z;
+			break;
+		}
+		case mixerCommandType::STOP_ALL: {
+			for (uint32_t slot : playing)
+				voices[slot].isPlaying = false;
+			playing.clear();
+			break;
+		}
+		}
+	}
+}
+
+void SoftwareMixer::stopVoice(uint32_t slot)
+{
+	MixVoice& voice = voices[slot];
+	if (!voice.isPlaying)
+		return;
+	voice.isPlaying = false;
+
+	// swap with the last one, and tell it where it went
+	const uint32_t last = playing.back();
+	playing[voice.playingIndex] = last;
+	voices[last].playingIndex = voice.playingIndex;
+	playing.pop_back();
+}
+
+void SoftwareMixer::mixVoice(MixVoice& voice, uint64_t blockStart, bool& isFinished)
+{
+	isFinished = false;
+	if (voice.startFrame >= blockStart + blockFrames)
+		return; // not yet
+
+	// a voice can start partway into the block, that is the whole point of the timestamps
+	const size_t offset = (voice.startFrame > blockStart) ? size_t(voice.startFrame - blockStart) : 0;
+
+	if (voice.isRelative) {
+		readVoice(voice, offset, 1.f, 1.f, mixBuffer.data(), isFinished);
+		return;
+	}
+
+	const float distance = sqrtf(voice.x * voice.x + voice.z * voice.z);
+	const float gain = getInverseDistanceGain(distance, minDistance, attenuation);
+
+	if (hrtfRenderer != nullptr) {
+		// dry and mono first, then the ears get it through the HRTF
+		std::fill(dryBuffer.begin(), dryBuffer.end(), 0.f);
+		readVoice(voice, offset, gain * 0.5f, gain * 0.5f, dryBuffer.data(), isFinished);
+		for (size_t i = 0; i < blockFrames; i++)
+			dryMono[i] = dryBuffer[i * 2] + dryBuffer[i * 2 + 1];
+
+		const float azimuth = (distance > 1.f) ? getHrtfAzimuth(voice.x, voice.z) : voice.binaural.azimuth;
+		hrtfRenderer->render(voice.binaural, dryMono.data(), blockFrames, azimuth, mixBuffer.data());
+		return;
+	}
+
+	// constant power pan from how far left or right the ear hears it
+	const float pan = (distance > 1.f) ? voice.x / distance : 0.f;
+	readVoice(voice, offset, gain * sqrtf((1.f - pan) * 0.5f), gain * sqrtf((1.f + pan) * 0.5f), mixBuffer.data(), isFinished);
+}
+
+// Adds the voice's next samples from offset to the end of the block into target
+void SoftwareMixer::readVoice(MixVoice& voice, size_t offset, float leftGain, float rightGain, float* target, bool& isFinished)
+{
+	const size_t frames = blockFrames - offset;
+	float* out = target + offset * 2;
+
+	if (voice.channelCount == 1 && voice.step == 1.0) {
+		size_t done = 0;
+		while (done < frames) {
+			const size_t start = size_t(voice.position);
+			const size_t count = std::min(frames - done, size_t(voice.frameCount) - start);
+			mixMono(voice.samples + start, count, leftGain, rightGain, out + done * 2);
+			done += count;
+			voice.position += double(count);
+			if (voice.position >= voice.frameCount) {
+				if (!voice.loop) {
+					isFinished = true;
+					return;
+				}
+				voice.position = 0.0;
+			}
+		}
+		return;
+	}
+
+	voice.position = mixResampled(voice.samples, voice.frameCount, voice.channelCount, voice.loop,
+		voice.position, voice.step, frames, leftGain, rightGain, out);
+	isFinished = !voice.loop && voice.position >= voice.frameCount;
+}
+
+bool SoftwareMixer::onGetData(Chunk& data)
+{
+	PROFILE_THREAD("mixer");
+	PROFILE_SCOPE("SoftwareMixer::onGetData");
+
+	runCommands();
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	std::fill(mixBuffer.begin(), mixBuffer.end(), 0.f);
+	for (size_t i = playing.size(); i-- > 0; ) {
+		bool isFinished;
+		mixVoice(voices[playing[i]], blockStartFrame, isFinished);
+		if (isFinished)
+			stopVoice(playing[i]);
+	}
+	toSamples(mixBuffer.data(), mixBuffer.size(), outputBuffer.data());
+
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - startTime;
+	mixNanoseconds += elapsed.count();
+	mixedVoiceBlocks += playing.size();
+	if (blockStartFrame % (blockFrames * 64) == 0 && mixedVoiceBlocks > 0) {
+		nsPerVoiceBlock.store(float(mixNanoseconds / mixedVoiceBlocks), std::memory_order_relaxed);
+		mixNanoseconds = 0.0;
+		mixedVoiceBlocks = 0;
+	}
+
+	blockStartFrame += blockFrames;
+	mixedFrames.store(blockStartFrame, std::memory_order_release);
+	activeVoiceCount.store(unsigned(playing.size()), std::memory_order_relaxed);
+
+	data.samples = outputBuffer.data();
+	data.sampleCount = outputBuffer.size();
+	return true;
+}
+
+void SoftwareMixer::onSeek(sf::Time)
+{
+	// a live mix has nothing to seek in
+}
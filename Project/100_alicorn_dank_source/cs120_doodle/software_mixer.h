@@ -0,0 +1,134 @@
+﻿/*
+  software_mixer.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "SFML/Audio.hpp"
+#include "spsc_ring.h"
+#include "hrtf.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+
+// Same inverse distance model OpenAL applies to its sources, shared so both backends sound alike
+inline float getInverseDistanceGain(float distance, float minDistance, float attenuation)
+{
+	if (distance <= minDistance)
+		return 1.f;
+	return minDistance / (minDistance + attenuation * (distance - minDistance));
+}
+
+enum class mixerCommandType {
+	PLAY, STOP, POSITION, DISTANCE_MODEL, STOP_ALL
+};
+
+struct MixerCommand {
+	mixerCommandType type = mixerCommandType::PLAY;
+	uint32_t slot = 0;  // 0 to SoftwareMixer::maxVoices, handed out by the game side
+
+	// PLAY, the samples stay owned by the soundCache entry they came from
+	const sf::Int16* samples = nullptr;
+	uint32_t frameCount = 0;
+	uint16_t channelCount = 1;
+	bool loop = false;
+	bool isRelative = false;  // follows the listener, like the player's own sounds
+	uint32_t sampleRate = 0;
+	uint64_t startFrame = 0;  // output frame to start on, can be in the future
+
+	// PLAY and POSITION, or minDistance / attenuation for DISTANCE_MODEL
+	float x = 0.f;
+	float z = 0.f;
+};
+
+// Optional backend for VoiceManager. Every voice is mixed in software into one stereo
+// sf::SoundStream, on the thread SFML runs the stream on, so there is no source cap.
+// The game thread only talks to it through a lock-free command ring; voices start on
+// the exact output frame they were scheduled for instead of on a frame boundary.
+// A voice lives in the slot the game picked for it, so no command has to search for it.
+// Binaural, every positioned voice is convolved with the HRTF for its direction
+// instead of being panned.
+class SoftwareMixer : public sf::SoundStream
+{
+public:
+	static constexpr unsigned int outputRate = 44100;
+	static constexpr unsigned int blockFrames = 512;     // ~11.6 ms per onGetData
+	static constexpr size_t maxVoices = 1024;
+	static constexpr size_t commandCapacity = 4096;
+	static constexpr const char* hrtfDataPath = "assets/hrtf.bin";
+
+	explicit SoftwareMixer(bool isBinaural = false);
+	~SoftwareMixer();
+
+	// game thread, false if the ring is full and the command was dropped
+	bool post(const MixerCommand& command);
+
+	// output frames handed to SFML so far, anything scheduled before this is already late
+	uint64_t getMixedFrames() const { return mixedFrames.load(std::memory_order_acquire); }
+	unsigned int getActiveVoiceCount() const { return activeVoiceCount.load(std::memory_order_relaxed); }
+	// average cost of mixing one voice for one block, over the last second or so
+	float getNsPerVoiceBlock() const { return nsPerVoiceBlock.load(std::memory_order_relaxed); }
+	// false when binaural had to fall back to the spherical head model
+	bool isUsingMeasuredHrtf() const { return isHrtfMeasured; }
+
+protected:
+	bool onGetData(Chunk& data) override;
+	void onSeek(sf::Time timeOffset) override;
+
+private:
+	struct MixVoice {
+		bool isPlaying = false;
+		uint32_t playingIndex = 0;  // where it is in playing
+		const sf::Int16* samples = nullptr;
+		uint32_t frameCount = 0;
+		uint16_t channelCount = 1;
+		bool loop = false;
+		bool isRelative = false;
+		double position = 0.0;  // in source frames
+		double step = 1.0;      // source frames per output frame
+		uint64_t startFrame = 0;
+		float x = 0.f;
+		float z = 0.f;
+		BinauralVoice binaural;
+	};
+
+	void runCommands();
+	void stopVoice(uint32_t slot);
+	void mixVoice(MixVoice& voice, uint64_t blockStart, bool& isFinished);
+	void readVoice(MixVoice& voice, size_t offset, float leftGain, float rightGain, float* target, bool& isFinished);
+
+	SpscRing<MixerCommand, commandCapacity> commands;
+
+	// audio thread only from here
+	std::vector<MixVoice> voices;     // maxVoices slots
+	std::vector<uint32_t> playing;    // slots of the voices that are playing
+	std::vector<float> mixBuffer;        // interleaved stereo, in 16 bit sample units
+	std::vector<sf::Int16> outputBuffer;
+	float minDistance = 500.f;
+	float attenuation = 0.3f;
+	uint64_t blockStartFrame = 0;
+
+	std::unique_ptr<HrtfSet> hrtf;
+	std::unique_ptr<BinauralRenderer> hrtfRenderer;
+	bool isHrtfMeasured = false;
+	std::vector<float> dryBuffer;  // one voice before convolution, stereo then folded to mono
+	std::vector<float> dryMono;
+	double mixNanoseconds = 0.0;
+	uint64_t mixedVoiceBlocks = 0;
+
+	std::atomic<uint64_t> mixedFrames{ 0 };
+	std::atomic<unsigned int> activeVoiceCount{ 0 };
+	std::atomic<float> nsPerVoiceBlock{ 0.f };
+};
@@ -0,0 +1,370 @@
+﻿/*
+  software_renderer.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "software_renderer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace doodle;
+
+
+
+namespace {
+
+	// src over dst, both straight alpha
+	void blend(Color4ub& pixel, uint32_t rgba)
+	{
+		const unsigned int alpha = rgba & 0xFF;
+		const unsigned int inverse = 255 - alpha;
+		pixel.red = Color4ub::unsigned_byte(((rgba >> 24) * alpha + pixel.red * inverse + 127) / 255);
+		pixel.green = Color4ub::unsigned_byte((((rgba >> 16) & 0xFF) * alpha + pixel.green * inverse + 127) / 255);
+		pixel.blue = Color4ub::unsigned_byte((((rgba >> 8) & 0xFF) * alpha + pixel.blue * inverse + 127) / 255);
+		pixel.alpha = Color4ub::unsigned_byte(alpha + (pixel.alpha * inverse + 127) / 255);
+	}
+
+	// every pixel whose center lies within [spanLeft, spanRight]
+	void fillSpan(Color4ub* line, float spanLeft, float spanRight, int left, int right, uint32_t color)
+	{
+		const int first = std::max(left, int(std::ceil(spanLeft - 0.5f)));
+		const int last = std::min(right - 1, int(std::floor(spanRight - 0.5f)));
+		if ((color & 0xFF) == 0xFF) {
+			if (first <= last)
+				std::fill(line + first, line + last + 1, Color4ub(HexColor{ color }));
+			return;
+		}
+		for (int column = first; column <= last; column++)
+			blend(line[column], color);
+	}
+
+	// half the width of an ellipse at dy from its center, negative outside
+	float getEllipseHalfWidth(float dy, float radiusX, float radiusY)
+	{
+		if (radiusX <= 0.0f || radiusY <= 0.0f)
+			return -1.0f;
+		const float v = dy / radiusY;
+		return (v * v <= 1.0f) ? radiusX * std::sqrt(1.0f - v * v) : -1.0f;
+	}
+
+}
+
+SoftwareRenderer::SoftwareRenderer(int newWidth, int newHeight, unsigned int threadCount)
+	: width(newWidth), height(newHeight)
+{
+	tilesAcross = (width + tileSize - 1) / tileSize;
+	tileCount = tilesAcross * ((height + tileSize - 1) / tileSize);
+	tileShapes.resize(size_t(tileCount));
+	image.ResizeToPixelWidthHeight(width, height);
+	settings.emplace_back();
+
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	// the thread calling endFrame() takes tiles too
+	for (unsigned int i = 1; i < threadCount; i++)
+		workers.emplace_back(&SoftwareRenderer::workerLoop, this);
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		isStopping = true;
+	}
+	wakeUp.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+void SoftwareRenderer::beginFrame()
+{
+	shapes.clear();
+	settings.resize(1);
+}
+
+void SoftwareRenderer::setShapeModes(EllipseMode ellipseMode, RectMode rectMode)
+{
+	settings.back().ellipseMode = ellipseMode;
+	settings.back().rectMode = rectMode;
+}
+
+void SoftwareRenderer::pushSettings()
+{
+	settings.push_back(settings.back());
+}
+
+void SoftwareRenderer::popSettings()
+{
+	if (settings.size() > 1)
+		settings.pop_back();
+}
+
+void SoftwareRenderer::pushShape(Shape& shape, float minX, float minY, float maxX, float maxY)
+{
+	shape.left = std::max(0, int(std::floor(minX)));
+	shape.top = std::max(0, int(std::floor(minY)));
+	shape.right = std::min(width, int(std::ceil(maxX)) + 1);
+	shape.bottom = std::min(height, int(std::ceil(maxY)) + 1);
+	if (shape.left < shape.right && shape.top < shape.bottom)
+		shapes.push_back(shape);
+}
+
+// The fill first and the outline over it, centered on the edge, like doodle
+void SoftwareRenderer::addEllipse(float centerX, float centerY, float radiusX, float radiusY)
+{
+	const DrawSettings& current = settings.back();
+	Shape shape;
+	shape.points[0] = centerX;
+	shape.points[1] = centerY;
+	shape.points[2] = radiusX;
+	shape.points[3] = radiusY;
+	shape.pointCount = 2;
+
+	if (current.isFilled && (current.fill.rgba & 0xFF) != 0) {
+		shape.type = shapeType::ELLIPSE;
+		shape.color = current.fill.rgba;
+		pushShape(shape, centerX - radiusX, centerY - radiusY, centerX + radiusX, centerY + radiusY);
+	}
+
+	if (current.isOutlined && (current.outline.rgba & 0xFF) != 0 && current.outlineWidth > 0.0f) {
+		const float halfWidth = current.outlineWidth / 2;
+		shape.type = shapeType::RING;
+		shape.color = current.outline.rgba;
+		shape.points[2] = radiusX + halfWidth;
+		shape.points[3] = radiusY + halfWidth;
+		shape.points[4] = radiusX - halfWidth;
+		shape.points[5] = radiusY - halfWidth;
+		pushShape(shape, centerX - shape.points[2], centerY - shape.points[3], centerX + shape.points[2], centerY + shape.points[3]);
+	}
+}
+
+// Takes the points in doodle's centered, y up coordinates
+void SoftwareRenderer::addPolygon(const float* points, int pointCount)
+{
+	const DrawSettings& current = settings.back();
+	Shape shape;
+	shape.type = shapeType::POLYGON;
+	shape.pointCount = pointCount;
+	for (int i = 0; i < pointCount; i++) {
+		shape.points[i * 2] = toPixelX(points[i * 2]);
+		shape.points[i * 2 + 1] = toPixelY(points[i * 2 + 1]);
+	}
+
+	if (current.isFilled && (current.fill.rgba & 0xFF) != 0) {
+		float minX = shape.points[0];
+		float maxX = shape.points[0];
+		float minY = shape.points[1];
+		float maxY = shape.points[1];
+		for (int i = 1; i < pointCount; i++) {
+			minX = std::min(minX, shape.points[i * 2]);
+			maxX = std::max(maxX, shape.points[i * 2]);
+			minY = std::min(minY, shape.points[i * 2 + 1]);
+			maxY = std::max(maxY, shape.points[i * 2 + 1]);
+		}
+		shape.color = current.fill.rgba;
+		pushShape(shape, minX, minY, maxX, maxY);
+	}
+
+	if (current.isOutlined && (current.outline.rgba & 0xFF) != 0 && current.outlineWidth > 0.0f) {
+		float corners[8];
+		std::copy(shape.points, shape.points + pointCount * 2, corners);
+		for (int i = 0; i < pointCount; i++) {
+			const int next = (i + 1) % pointCount;
+			addSegment(corners[i * 2], corners[i * 2 + 1], corners[next * 2], corners[next * 2 + 1],
+				current.outlineWidth / 2, current.outline.rgba);
+		}
+	}
+}
+
+// A thick line as the quad around it, in pixels
+void SoftwareRenderer::addSegment(float x1, float y1, float x2, float y2, float halfWidth, uint32_t color)
+{
+	const float dx = x2 - x1;
+	const float dy = y2 - y1;
+	const float length = std::sqrt(dx * dx + dy * dy);
+	if (length == 0.0f)
+		return;
+	const float normalX = -dy / length * halfWidth;
+	const float normalY = dx / length * halfWidth;
+
+	Shape shape;
+	shape.type = shapeType::POLYGON;
+	shape.pointCount = 4;
+	shape.color = color;
+	const float corners[8] = { x1 + normalX, y1 + normalY, x2 + normalX, y2 + normalY,
+		x2 - normalX, y2 - normalY, x1 - normalX, y1 - normalY };
+	std::copy(corners, corners + 8, shape.points);
+	pushShape(shape, std::min(x1, x2) - halfWidth, std::min(y1, y2) - halfWidth, std::max(x1, x2) + halfWidth, std::max(y1, y2) + halfWidth);
+}
+
+void SoftwareRenderer::drawEllipse(float x, float y, float ellipseWidth, float ellipseHeight)
+{
+	if (ellipseHeight == 0.0f)
+		ellipseHeight = ellipseWidth;
+	if (settings.back().ellipseMode == EllipseMode::Corner) {
+		x += ellipseWidth / 2;
+		y += ellipseHeight / 2;
+	}
+	addEllipse(toPixelX(x), toPixelY(y), std::abs(ellipseWidth) / 2, std::abs(ellipseHeight) / 2);
+}
+
+void SoftwareRenderer::drawRectangle(float x, float y, float rectangleWidth, float rectangleHeight)
+{
+	if (rectangleHeight == 0.0f)
+		rectangleHeight = rectangleWidth;
+	if (settings.back().rectMode == RectMode::Center) {
+		x -= rectangleWidth / 2;
+		y -= rectangleHeight / 2;
+	}
+	const float points[8] = { x, y, x + rectangleWidth, y, x + rectangleWidth, y + rectangleHeight, x, y + rectangleHeight };
+	addPolygon(points, 4);
+}
+
+void SoftwareRenderer::drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+	const float points[6] = { x1, y1, x2, y2, x3, y3 };
+	addPolygon(points, 3);
+}
+
+void SoftwareRenderer::drawQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4)
+{
+	const float points[8] = { x1, y1, x2, y2, x3, y3, x4, y4 };
+	addPolygon(points, 4);
+}
+
+void SoftwareRenderer::drawLine(float x1, float y1, float x2, float y2)
+{
+	const DrawSettings& current = settings.back();
+	if (current.isOutlined && (current.outline.rgba & 0xFF) != 0 && current.outlineWidth > 0.0f)
+		addSegment(toPixelX(x1), toPixelY(y1), toPixelX(x2), toPixelY(y2), current.outlineWidth / 2, current.outline.rgba);
+}
+
+void SoftwareRenderer::endFrame()
+{
+	// every tile gets the shapes that may touch it, still in submission order
+	for (std::vector<uint32_t>& tile : tileShapes)
+		tile.clear();
+	for (uint32_t i = 0; i < shapes.size(); i++) {
+		const Shape& shape = shapes[i];
+		for (int tileY = shape.top / tileSize; tileY <= (shape.bottom - 1) / tileSize; tileY++)
+			for (int tileX = shape.left / tileSize; tileX <= (shape.right - 1) / tileSize; tileX++)
+				tileShapes[size_t(tileY * tilesAcross + tileX)].push_back(i);
+	}
+
+	nextTile.store(0);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		busyWorkers = unsigned(workers.size());
+		frameGeneration++;
+	}
+	wakeUp.notify_all();
+
+	rasterizeTiles();
+
+	std::unique_lock<std::mutex> guard(lock);
+	finished.wait(guard, [this] { return busyWorkers == 0; });
+}
+
+void SoftwareRenderer::workerLoop()
+{
+	unsigned int seenGeneration = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wakeUp.wait(guard, [&] { return isStopping || frameGeneration != seenGeneration; });
+			if (isStopping)
+				return;
+			seenGeneration = frameGeneration;
+		}
+
+		rasterizeTiles();
+
+		std::lock_guard<std::mutex> guard(lock);
+		if (--busyWorkers == 0)
+			finished.notify_one();
+	}
+}
+
+void SoftwareRenderer::rasterizeTiles()
+{
+	for (int tile = nextTile.fetch_add(1); tile < tileCount; tile = nextTile.fetch_add(1))
+		rasterizeTile(tile);
+}
+
+void SoftwareRenderer::rasterizeTile(int tile)
+{
+	const int tileLeft = (tile % tilesAcross) * tileSize;
+	const int tileTop = (tile / tilesAcross) * tileSize;
+	const int tileRight = std::min(width, tileLeft + tileSize);
+	const int tileBottom = std::min(height, tileTop + tileSize);
+
+	Color4ub* pixels = image.GetPixelsPointer();
+	const Color4ub clearColor = background;
+	for (int row = tileTop; row < tileBottom; row++)
+		std::fill(pixels + size_t(row) * width + tileLeft, pixels + size_t(row) * width + tileRight, clearColor);
+
+	for (uint32_t index : tileShapes[size_t(tile)]) {
+		const Shape& shape = shapes[index];
+		const int left = std::max(tileLeft, shape.left);
+		const int right = std::min(tileRight, shape.right);
+		const int top = std::max(tileTop, shape.top);
+		const int bottom = std::min(tileBottom, shape.bottom);
+		const float* p = shape.points;
+
+		for (int row = top; row < bottom; row++) {
+			const float py = row + 0.5f;
+			Color4ub* line = pixels + size_t(row) * width;
+
+			switch (shape.type) {
+			case shapeType::ELLIPSE: {
+				const float halfWidth = getEllipseHalfWidth(py - p[1], p[2], p[3]);
+				if (halfWidth >= 0.0f)
+					fillSpan(line, p[0] - halfWidth, p[0] + halfWidth, left, right, shape.color);
+				break;
+			}
+			case shapeType::RING: {
+				const float outer = getEllipseHalfWidth(py - p[1], p[2], p[3]);
+				if (outer < 0.0f)
+					break;
+				const float inner = getEllipseHalfWidth(py - p[1], p[4], p[5]);
+				if (inner < 0.0f) {
+					fillSpan(line, p[0] - outer, p[0] + outer, left, right, shape.color);
+					break;
+				}
+				// the pixel right on the inner edge belongs to neither side
+				fillSpan(line, p[0] - outer, std::nextafter(p[0] - inner, p[0] - outer), left, right, shape.color);
+				fillSpan(line, std::nextafter(p[0] + inner, p[0] + outer), p[0] + outer, left, right, shape.color);
+				break;
+			}
+			case shapeType::POLYGON: {
+				// convex, so the row crosses it in one span between the edges it meets
+				float spanLeft = float(width);
+				float spanRight = -1.0f;
+				for (int i = 0; i < shape.pointCount; i++) {
+					const int next = (i + 1) % shape.pointCount;
+					const float x1 = p[i * 2];
+					const float y1 = p[i * 2 + 1];
+					const float x2 = p[next * 2];
+					const float y2 = p[next * 2 + 1];
+					if ((py < y1 && py < y2) || (py > y1 && py > y2) || y1 == y2)
+						continue;
+					const float x = x1 + (py - y1) * (x2 - x1) / (y2 - y1);
+					spanLeft = std::min(spanLeft, x);
+					spanRight = std::max(spanRight, x);
+				}
+				if (spanLeft <= spanRight)
+					fillSpan(line, spanLeft, spanRight, left, right, shape.color);
+				break;
+			}
+			}
+		}
+	}
+}
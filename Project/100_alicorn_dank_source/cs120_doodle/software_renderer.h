@@ -0,0 +1,126 @@
+﻿/*
+  software_renderer.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "renderer.h"
+#include <doodle/image.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+// Draws the frame on the CPU into a doodle::Image, so frames can be saved with
+// SaveToPNG and compared, or timed, on a machine without a GPU. The commands are
+// only collected until endFrame(); then the image is cut into tiles that the worker
+// threads and the calling thread rasterize in parallel, each tile on its own.
+// Every shape is filled a row span at a time and alpha blended in submission order
+// with one sample per pixel. Outlines and lines become their own shapes; text is not
+// drawn.
+class SoftwareRenderer : public Renderer {
+public:
+	static constexpr int tileSize = 64;
+
+	// threadCount 0 uses every core
+	SoftwareRenderer(int width, int height, unsigned int threadCount = 0);
+	~SoftwareRenderer();
+
+	SoftwareRenderer(const SoftwareRenderer&) = delete;
+	SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+	void setBackground(doodle::HexColor color) { background = color; }
+
+	void beginFrame() override;
+	void endFrame() override;
+
+	void setShapeModes(doodle::EllipseMode ellipseMode, doodle::RectMode rectMode) override;
+
+	void pushSettings() override;
+	void popSettings() override;
+	void setFill(doodle::HexColor color) override { settings.back().fill = color; settings.back().isFilled = true; }
+	void noFill() override { settings.back().isFilled = false; }
+	void setOutline(doodle::HexColor color) override { settings.back().outline = color; settings.back().isOutlined = true; }
+	void noOutline() override { settings.back().isOutlined = false; }
+	void setOutlineWidth(float width) override { settings.back().outlineWidth = width; }
+	void setFontSize(float) override {}
+
+	void drawEllipse(float x, float y, float width, float height) override;
+	void drawRectangle(float x, float y, float width, float height) override;
+	void drawTriangle(float x1, float y1, float x2, float y2, float x3, float y3) override;
+	void drawQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) override;
+	void drawLine(float x1, float y1, float x2, float y2) override;
+	void drawText(const std::string&, float, float) override {}
+
+	// what the last endFrame() drew
+	const doodle::Image& getImage() const { return image; }
+	unsigned int getThreadCount() const { return unsigned(workers.size()) + 1; }
+
+private:
+	struct DrawSettings {
+		doodle::HexColor fill{ defaultDrawFill };
+		doodle::HexColor outline{ defaultDrawOutline };
+		float outlineWidth = defaultDrawOutlineWidth;
+		bool isFilled = true;
+		bool isOutlined = true;
+		doodle::EllipseMode ellipseMode = doodle::EllipseMode::Center;
+		doodle::RectMode rectMode = doodle::RectMode::Corner;
+	};
+
+	enum class shapeType : unsigned char {
+		ELLIPSE, RING, POLYGON
+	};
+
+	// In pixels, y going down. An ellipse keeps its center and radii in points, a ring
+	// the inner radii after those; a polygon is convex with up to four corners.
+	struct Shape {
+		float points[8];
+		int pointCount;
+		uint32_t color;
+		shapeType type;
+		int left, top, right, bottom;  // pixels it may touch, right and bottom excluded
+	};
+
+	void pushShape(Shape& shape, float minX, float minY, float maxX, float maxY);
+	void addEllipse(float centerX, float centerY, float radiusX, float radiusY);
+	void addPolygon(const float* points, int pointCount);
+	void addSegment(float x1, float y1, float x2, float y2, float halfWidth, uint32_t color);
+	float toPixelX(float x) const { return x + width / 2.0f; }
+	float toPixelY(float y) const { return height / 2.0f - y; }
+	void rasterizeTiles();
+	void rasterizeTile(int tile);
+	void workerLoop();
+
+	int width;
+	int height;
+	int tilesAcross;
+	int tileCount;
+	doodle::HexColor background{ 0x000000FF };
+	doodle::Image image;
+
+	std::vector<DrawSettings> settings;
+	std::vector<Shape> shapes;
+	std::vector<std::vector<uint32_t>> tileShapes;
+
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable wakeUp;
+	std::condition_variable finished;
+	unsigned int frameGeneration = 0;
+	unsigned int busyWorkers = 0;
+	bool isStopping = false;
+	std::atomic<int> nextTile{ 0 };
+};
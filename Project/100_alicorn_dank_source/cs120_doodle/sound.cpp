@@ -18,8 +18,149 @@ using namespace sf;
 	
 
 
-void loadSound(const std::string& file_path) 
+SoundHandle SoundCache::acquire(const std::string& filePath)
 {
-	SoundBuffers.emplace_back();
-	SoundBuffers.back().loadFromFile(file_path);
-}
\ No newline at end of file
+	auto found = byPath.find(filePath);
+	if (found != byPath.end()) {
+		Asset& asset = assets[found->second];
+		asset.refCount++;
+		hits++;
+		return SoundHandle{ found->second, asset.generation };
+	}
+
+	std::unique_ptr<SoundBuffer> buffer = std::make_unique<SoundBuffer>();
+	decodes++;
+	if (!buffer->loadFromFile(filePath))
+		return SoundHandle{};
+
+	const unsigned int index = store(filePath, std::move(buffer));
+	assets[index].refCount = 1;
+	trimToBudget();
+
+	return SoundHandle{ index, assets[index].generation };
+}
+
+void SoundCache::insertDecoded(const std::string& filePath, const Int16* samples, size_t sampleCount,
+	unsigned int channelCount, unsigned int sampleRate)
+{
+	if (byPath.count(filePath) > 0)
+		return;
+
+	std::unique_ptr<SoundBuffer> buffer = std::make_unique<SoundBuffer>();
+	decodes++;
+	if (!buffer->loadFromSamples(samples, sampleCount, channelCount, sampleRate))
+		return;
+
+	const unsigned int index = store(filePath, std::move(buffer));
+	assets[index].lastReleased = ++releaseCount;
+	trimToBudget();
+}
+
+unsigned int SoundCache::store(const std::string& filePath, std::unique_ptr<SoundBuffer> buffer)
+{
+	unsigned int index;
+	if (!freeAssets.empty()) {
+		index = freeAssets.back();
+		freeAssets.pop_back();
+	}
+	else {
+		index = static_cast<unsigned int>(assets.size());
+		assets.emplace_back();
+	}
+
+	Asset& asset = assets[index];
+	asset.filePath = filePath;
+	asset.bytes = static_cast<size_t>(buffer->getSampleCount()) * sizeof(Int16);
+	asset.buffer = std::move(buffer);
+	asset.refCount = 0;
+	residentBytes += asset.bytes;
+	byPath[filePath] = index;
+	return index;
+}
+
+void SoundCache::release(const SoundHandle& handle)
+{
+	if (!isResident(handle))
+		return;
+
+	Asset& asset = assets[handle.index];
+	if (asset.refCount == 0)
+		return;
+	if (--asset.refCount == 0) {
+		asset.lastReleased = ++releaseCount;
+		trimToBudget();
+	}
+}
+
+const SoundBuffer* SoundCache::get(const SoundHandle& handle) const
+{
+	return isResident(handle) ? assets[handle.index].buffer.get() : nullptr;
+}
+
+bool SoundCache::isResident(const SoundHandle& handle) const
+{
+	return handle.index < assets.size() &&
+		assets[handle.index].generation == handle.generation &&
+		assets[handle.index].buffer != nullptr;
+}
+
+void SoundCache::setBudget(size_t bytes)
+{
+	budgetBytes = bytes;
+	trimToBudget();
+}
+
+void SoundCache::purgeUnused()
+{
+	for (unsigned int i = 0; i < assets.size(); i++) {
+		if (assets[i].buffer != nullptr && assets[i].refCount == 0)
+			unload(i);
+	}
+}
+
+void SoundCache::unload(unsigned int index)
+{
+	// SoundBuffer detaches whatever sf::Sound was still playing it
+	Asset& asset = assets[index];
+	residentBytes -= asset.bytes;
+	byPath.erase(asset.filePath);
+
+	asset.buffer.reset();
+	asset.filePath.clear();
+	asset.bytes = 0;
+	asset.generation++;
+	freeAssets.push_back(index);
+}
+
+// Only assets nobody holds are ever dropped, so the budget can be exceeded by what is in use
+void SoundCache::trimToBudget()
+{
+	while (residentBytes > budgetBytes) {
+		int oldest = -1;
+		for (unsigned int i = 0; i < assets.size(); i++) {
+			if (assets[i].buffer == nullptr || assets[i].refCount > 0)
+				continue;
+			if (oldest < 0 || assets[i].lastReleased < assets[oldest].lastReleased)
+				oldest = int(i);
+		}
+		if (oldest < 0)
+			return;
+		unload(static_cast<unsigned int>(oldest));
+	}
+}
+
+SoundCacheStats SoundCache::getStats() const
+{
+	SoundCacheStats stats;
+	for (const Asset& asset : assets) {
+		if (asset.buffer == nullptr)
+			continue;
+		stats.assets++;
+		if (asset.refCount > 0)
+			stats.referencedAssets++;
+	}
+	stats.residentBytes = residentBytes;
+	stats.decodes = decodes;
+	stats.hits = hits;
+	return stats;
+}
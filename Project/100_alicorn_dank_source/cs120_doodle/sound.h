@@ -13,7 +13,71 @@
 
 #pragma once
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "SFML/Audio.hpp"
+#include "slot_map.h"
 
 
 
-void loadSound(const std::string& file_path);
\ No newline at end of file
+using SoundHandle = SlotHandle;
+
+struct SoundCacheStats {
+	size_t assets = 0;             // decoded and resident
+	size_t referencedAssets = 0;   // of those, still acquired by someone
+	size_t residentBytes = 0;      // PCM samples of every resident asset
+	unsigned int decodes = 0;      // files actually read from disk
+	unsigned int hits = 0;         // acquires answered from memory
+};
+
+// Decodes each sound file once and hands out handles to it. A buffer never moves
+// while it is resident, so an sf::Sound playing it stays valid however many others
+// get loaded. When the last owner releases an asset it is kept around, unused, and
+// only freed once the resident bytes go over the budget or purgeUnused() is called,
+// so leaving gameplay and coming back does not decode everything again.
+class SoundCache
+{
+public:
+	static constexpr size_t defaultBudgetBytes = 64 * 1024 * 1024;
+
+	// invalid handle if the file could not be decoded, SFML has already said why
+	SoundHandle acquire(const std::string& filePath);
+	// for a file decoded elsewhere (AssetLoader), resident but unowned until acquired
+	void insertDecoded(const std::string& filePath, const sf::Int16* samples, size_t sampleCount,
+		unsigned int channelCount, unsigned int sampleRate);
+	void release(const SoundHandle& handle);
+
+	// nullptr once the handle is stale
+	const sf::SoundBuffer* get(const SoundHandle& handle) const;
+
+	void setBudget(size_t bytes);
+	void purgeUnused();
+
+	SoundCacheStats getStats() const;
+
+private:
+	struct Asset {
+		std::string filePath;
+		std::unique_ptr<sf::SoundBuffer> buffer;
+		size_t bytes = 0;
+		unsigned int refCount = 0;
+		unsigned int lastReleased = 0; // release order, the oldest unused one goes first
+		unsigned int generation = 0;
+	};
+
+	unsigned int store(const std::string& filePath, std::unique_ptr<sf::SoundBuffer> buffer);
+	bool isResident(const SoundHandle& handle) const;
+	void unload(unsigned int index);
+	void trimToBudget();
+
+	std::vector<Asset> assets;
+	std::vector<unsigned int> freeAssets;
+	std::unordered_map<std::string, unsigned int> byPath;
+
+	size_t budgetBytes = defaultBudgetBytes;
+	size_t residentBytes = 0;
+	unsigned int releaseCount = 0;
+	unsigned int decodes = 0;
+	unsigned int hits = 0;
+};
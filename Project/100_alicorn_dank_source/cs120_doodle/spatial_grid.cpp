@@ -0,0 +1,192 @@
+﻿/*
+  spatial_grid.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "spatial_grid.h"
+#include "game_object.h"
+#include "useful_functions.h"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+
+
+long long SpatialGrid::cellKey(int cellX, int cellY)
+{
+	return (static_cast<long long>(cellX) << 32) | static_cast<unsigned int>(cellY);
+}
+
+int SpatialGrid::toCell(float coord)
+{
+	return static_cast<int>(floorf(coord / gridCellSize));
+}
+
+vector<GameObject*>* SpatialGrid::findCell(int cellX, int cellY)
+{
+	auto it = cells.find(cellKey(cellX, cellY));
+	if (it == cells.end() || it->second.empty())
+		return nullptr;
+	return &it->second;
+}
+
+void SpatialGrid::insert(GameObject* obj, const Vector& pos)
+{
+	if (obj->isInGrid)
+		return;
+
+	obj->gridCellX = toCell(pos.x);
+	obj->gridCellY = toCell(pos.y);
+	obj->isInGrid = true;
+
+	cells[cellKey(obj->gridCellX, obj->gridCellY)].push_back(obj);
+	++objectCount;
+}
+
+void SpatialGrid::remove(GameObject* obj)
+{
+	if (!obj->isInGrid)
+		return;
+
+	vector<GameObject*>& cell = cells[cellKey(obj->gridCellX, obj->gridCellY)];
+	auto it = find(cell.begin(), cell.end(), obj);
+	if (it != cell.end())
+	{
+		// order inside a cell doesn't matter, so swap with the back instead of shifting
+		*it = cell.back();
+		cell.pop_back();
+	}
+
+	obj->isInGrid = false;
+	--objectCount;
+}
+
+void SpatialGrid::move(GameObject* obj, const Vector& oldPos, const Vector& newPos)
+{
+	// most frames an enemy stays in the same cell, so this is the common exit
+	// (and it doesn't have to touch the object at all)
+	if (toCell(oldPos.x) == toCell(newPos.x) && toCell(oldPos.y) == toCell(newPos.y))
+		return;
+
+	if (!obj->isInGrid)
+		return;
+
+	remove(obj);
+	insert(obj, newPos);
+}
+
+void SpatialGrid::clear()
+{
+	for (auto& cell : cells)
+	{
+		for (GameObject* obj : cell.second)
+			obj->isInGrid = false;
+	}
+	cells.clear();
+	objectCount = 0;
+}
+
+bool SpatialGrid::getFirstObjectHitByRay(const Vector& originPoint, const Vector& endPoint, GameObject*& p_obj)
+{
+	p_obj = nullptr;
+	if (objectCount == 0)
+		return false;
+
+	// every object is stamped once per query, so overlapping neighbourhoods don't test it twice
+	++queryStamp;
+
+	Line ray(originPoint, endPoint);
+	Vector rayDir = endPoint - originPoint;
+	float rayLength = rayDir.length();
+
+	float closestDistance = FLT_MAX;
+
+	int cellX = toCell(originPoint.x);
+	int cellY = toCell(originPoint.y);
+	const int endCellX = toCell(endPoint.x);
+	const int endCellY = toCell(endPoint.y);
+
+	const int stepX = (rayDir.x > 0.f) ? 1 : -1;
+	const int stepY = (rayDir.y > 0.f) ? 1 : -1;
+
+	// Amanatides & Woo traversal, t is the ray parameter in [0, 1]
+	float tMaxX = FLT_MAX, tDeltaX = FLT_MAX;
+	float tMaxY = FLT_MAX, tDeltaY = FLT_MAX;
+	if (rayDir.x != 0.f)
+	{
+		float boundaryX = (cellX + (stepX > 0 ? 1 : 0)) * gridCellSize;
+		tMaxX = (boundaryX - originPoint.x) / rayDir.x;
+		tDeltaX = gridCellSize / fabsf(rayDir.x);
+	}
+	if (rayDir.y != 0.f)
+	{
+		float boundaryY = (cellY + (stepY > 0 ? 1 : 0)) * gridCellSize;
+		tMaxY = (boundaryY - originPoint.y) / rayDir.y;
+		tDeltaY = gridCellSize / fabsf(rayDir.y);
+	}
+
+	float tEntry = 0.f;
+	while (true)
+	{
+		// Anything not tested yet crosses the ray beyond tEntry, so its center is at least
+		// (tEntry * rayLength - half a cell) away. Once that's past the best hit we are done.
+		if (p_obj != nullptr && tEntry * rayLength - gridCellSize / 2.f > closestDistance)
+			break;
+
+		for (int offsetY = -1; offsetY <= 1; offsetY++)
+		{
+			for (int offsetX = -1; offsetX <= 1; offsetX++)
+			{
+				vector<GameObject*>* cell = findCell(cellX + offsetX, cellY + offsetY);
+				if (cell == nullptr)
+					continue;
+
+				for (GameObject* obj : *cell)
+				{
+					if (obj->rayQueryStamp == queryStamp)
+						continue;
+					obj->rayQueryStamp = queryStamp;
+
+					if (!isObjectHitByRay(ray, obj))
+						continue;
+
+					float distance = (obj->getPos2D() - originPoint).length();
+					if (distance < closestDistance)
+					{
+						closestDistance = distance;
+						p_obj = obj;
+					}
+				}
+			}
+		}
+
+		if (cellX == endCellX && cellY == endCellY)
+			break;
+
+		if (tMaxX < tMaxY)
+		{
+			tEntry = tMaxX;
+			tMaxX += tDeltaX;
+			cellX += stepX;
+		}
+		else
+		{
+			tEntry = tMaxY;
+			tMaxY += tDeltaY;
+			cellY += stepY;
+		}
+
+		if (tEntry > 1.f)
+			break;
+	}
+
+	return p_obj != nullptr;
+}
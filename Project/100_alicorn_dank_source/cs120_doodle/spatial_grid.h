@@ -0,0 +1,50 @@
+﻿/*
+  spatial_grid.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "basic_math.h"
+#include <unordered_map>
+#include <vector>
+
+
+
+class GameObject;
+
+constexpr float gridCellSize = 140.0f; // objects must fit inside a cell (enemyDrawSize * 2)
+
+// Uniform hashed grid over enemy positions, used as the broadphase of the cannon ray.
+// Each object is bucketed by its center, so a ray only has to look at the cells it
+// crosses plus their neighbours.
+class SpatialGrid
+{
+public:
+	void insert(GameObject* obj, const Vector& pos);
+	void remove(GameObject* obj);
+	void move(GameObject* obj, const Vector& oldPos, const Vector& newPos);
+	void clear();
+
+	size_t size() const { return objectCount; }
+
+	bool getFirstObjectHitByRay(const Vector& originPoint, const Vector& endPoint, GameObject*& p_obj);
+
+private:
+	static long long cellKey(int cellX, int cellY);
+	static int toCell(float coord);
+
+	std::vector<GameObject*>* findCell(int cellX, int cellY);
+
+	std::unordered_map<long long, std::vector<GameObject*>> cells;
+	size_t objectCount = 0;
+	unsigned int queryStamp = 0;
+};
@@ -0,0 +1,70 @@
+﻿/*
+  spsc_ring.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+
+
+// Fixed size queue between exactly one producer thread and one consumer thread.
+// Neither side ever locks or allocates; push() fails when the ring is full instead
+// of waiting. Capacity has to be a power of two.
+template<typename T, size_t capacity>
+class SpscRing
+{
+	static_assert((capacity & (capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+	// producer side
+	bool push(const T& value)
+	{
+		const size_t tail = writeIndex.load(std::memory_order_relaxed);
+		if (tail - readIndex.load(std::memory_order_acquire) == capacity)
+			return false;
+
+		items[tail & (capacity - 1)] = value;
+		writeIndex.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer side
+	bool pop(T& value)
+	{
+		const size_t head = readIndex.load(std::memory_order_relaxed);
+		if (head == writeIndex.load(std::memory_order_acquire))
+			return false;
+
+		value = items[head & (capacity - 1)];
+		readIndex.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// only a hint from either side, the other one may be moving it
+	size_t size() const
+	{
+		return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+	}
+
+private:
+	// each index on its own cache line, so the two threads don't keep stealing it from each other.
+	// Padded by hand, alignas makes MSVC warn about the padding it adds (C4324).
+	static constexpr size_t cacheLine = 64;
+
+	std::atomic<size_t> writeIndex{ 0 };
+	char writePadding[cacheLine - sizeof(std::atomic<size_t>)] = {};
+	std::atomic<size_t> readIndex{ 0 };
+	char readPadding[cacheLine - sizeof(std::atomic<size_t>)] = {};
+	T items[capacity];
+};
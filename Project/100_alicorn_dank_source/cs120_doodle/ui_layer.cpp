@@ -0,0 +1,49 @@
+﻿/*
+  ui_layer.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "ui_layer.h"
+#include <doodle/doodle.hpp>
+using namespace doodle;
+
+
+
+bool UiLayer::isUpToDate() const
+{
+	return isCached && cachedWidth == Width && cachedHeight == Height;
+}
+
+void UiLayer::drawTexture() const
+{
+	push_settings();
+	set_frame_of_reference(RightHanded_OriginBottomLeft);
+	set_texture_mode(RectMode::Corner);
+	no_tint();
+	draw_texture(texture, 0.f, 0.f, (float)Width, (float)Height);
+	pop_settings();
+}
+
+void UiLayer::capture()
+{
+	Image image = capture_screenshot_to_image();
+
+	// the background clears translucent, the colors read back are already what is on screen
+	Color4ub* pixels = image.GetPixelsPointer();
+	const int pixelCount = image.GetWidth() * image.GetHeight();
+	for (int i = 0; i < pixelCount; i++)
+		pixels[i].alpha = 255;
+
+	isCached = texture.LoadFromImage(image);
+	cachedWidth = Width;
+	cachedHeight = Height;
+	rebuildCount++;
+}
@@ -0,0 +1,56 @@
+﻿/*
+  ui_layer.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include <doodle/texture.hpp>
+
+
+
+// The part of a screen that holds still, drawn once, read back off the back buffer into a
+// texture and from then on drawn as that one texture. What changes goes on top of it every
+// frame. A resized window, or invalidate(), draws it afresh.
+class UiLayer
+{
+public:
+	// drawContent() draws the layer and returns false while something it needs is still
+	// loading, which keeps it from being cached so it tries again next frame.
+	// Call it before drawing anything that moves, the readback takes all that is on screen.
+	template<typename DrawContent>
+	void draw(DrawContent drawContent);
+
+	void invalidate() { isCached = false; }
+	bool isUpToDate() const;
+	unsigned int getRebuildCount() const { return rebuildCount; }
+
+private:
+	void drawTexture() const;
+	void capture();
+
+	doodle::Texture texture;
+	bool isCached = false;
+	int cachedWidth = 0;
+	int cachedHeight = 0;
+	unsigned int rebuildCount = 0;
+};
+
+template<typename DrawContent>
+void UiLayer::draw(DrawContent drawContent)
+{
+	if (isUpToDate()) {
+		drawTexture();
+		return;
+	}
+	if (drawContent())
+		capture();
+}
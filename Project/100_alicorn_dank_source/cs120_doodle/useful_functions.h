@@ -19,6 +19,8 @@
 
 class GameObject;
 
+bool isObjectHitByRay(const Line& ray, const GameObject* obj);
+
 bool getFirstObjectHitByRay(const Vector& originPoint, const Vector& endPoint, GameObject*& p_obj);
 
 
@@ -33,15 +33,31 @@ HexColor red5 = 0xA21212FF;
 
 vector<player*> playerList;
 
-vector<vector<enemy*>> tempEnemyList;
-vector<vector<enemy*>> enemyList;
+vector<EnemyStorage> enemyList;
+vector<enemy*> destroyedEnemyList;
+SpatialGrid enemyGrid;
 
-vector<sf::SoundBuffer> SoundBuffers{};
+SoundCache soundCache;
+vector<SoundHandle> gameSounds{};
+AssetLoader assetLoader;
 vector<sf::Sound>       Sounds{};
+VoiceManager voiceManager;
 
 sf::Music music;
 
+RenderQueue renderQueue;
+DoodleRenderer doodleRenderer;
+Renderer* renderer = &doodleRenderer;
+
+InputQueue inputQueue;
+FramePacer framePacer;
+
+RandomStream gameplayRandom;
+RandomStream spawnRandom;
+RandomStream cosmeticRandom;
+
 Game newGame;
+Simulation simulation;
 
 unsigned int gameWave = 1;
 unsigned int maxWave = 5;
@@ -56,6 +72,5 @@ bool isDownKeyDown = false;
 bool isLeftKeyDown = false;
 bool isRightKeyDown = false;
 bool isSpaceKeyDown = false;
-bool isESCKeyDown = false;
 
 bool isProjectionOverlayed = false;
\ No newline at end of file
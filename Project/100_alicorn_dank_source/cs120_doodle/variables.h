@@ -19,11 +19,23 @@ using namespace doodle;
 #include "SFML/Audio.hpp"
 #include <vector>
 #include "game.h"
+#include "spatial_grid.h"
+#include "slot_map.h"
+#include "enemy_storage.h"
+#include "simulation.h"
+#include "voice_manager.h"
+#include "asset_loader.h"
+#include "render_queue.h"
+#include "renderer.h"
+#include "random_stream.h"
+#include "frame_pacer.h"
 
 
 
 constexpr int playerLife = 5;
-constexpr int targetFrameRate = 1;
+constexpr int targetFrameRate = 60; // --fps changes it
+constexpr int staticScreenFrameRate = 20;
+constexpr int unfocusedFrameRate = 5;
 
 constexpr int circleFlag = 1;
 
@@ -61,14 +73,16 @@ extern float globalDeltaTime;
 
 inline bool isStereoReversed = false;
 
+//what the simulation holds down this tick, set by Simulation::tick() from the input queue
 extern bool isUpKeyDown;
 extern bool isDownKeyDown;
 extern bool isLeftKeyDown;
 extern bool isRightKeyDown;
 extern bool isSpaceKeyDown;
-extern bool isESCKeyDown;
 
 extern bool isProjectionOverlayed;
+inline bool isVoiceStatsShown = false;
+inline bool isRenderStatsShown = false;
 
 extern HexColor defaultFillColor;
 constexpr float defaultEdgeWidth = 1.5f;
@@ -97,17 +111,43 @@ class enemy;
 
 extern std::vector<player*> playerList;
 
-//tempEnemyList store enemy info before came out
-extern std::vector<std::vector<enemy*>> tempEnemyList;
-//EnemyList store enemy info after came out
-extern std::vector<std::vector<enemy*>> enemyList;
-
-extern vector<sf::SoundBuffer> SoundBuffers;
+//EnemyList store enemy info after came out, an enemy keeps its own handle into it
+extern std::vector<EnemyStorage> enemyList;
+//enemies killed this frame, removed from enemyList all at once by flushDestroyedEnemies()
+extern std::vector<enemy*> destroyedEnemyList;
+//broadphase over the enemies of the current wave, kept in sync by the enemy itself
+extern SpatialGrid enemyGrid;
+
+extern SoundCache soundCache;
+//what GamePlay acquired from soundCache, indexed like enemy::audioIndex()
+extern vector<SoundHandle> gameSounds;
+//decodes textures and sounds off the main thread, everything is requested during the splash
+extern AssetLoader assetLoader;
 extern vector<sf::Sound>       Sounds;
+//every game sound goes through here, it owns the only sf::Sound objects that play them
+extern VoiceManager voiceManager;
 
 extern sf::Music music;
 
+//gameplay draws go in here and reach the renderer sorted, once per frame
+extern RenderQueue renderQueue;
+//where gameplay frames go, the window unless main() picked a headless backend
+extern DoodleRenderer doodleRenderer;
+extern Renderer* renderer;
+
+//seeded by every Simulation session; anything drawn from gameplayRandom or spawnRandom
+//has to happen inside a tick, or replays stop matching
+extern RandomStream gameplayRandom;
+extern RandomStream spawnRandom;
+extern RandomStream cosmeticRandom;
+
+//timestamped key events, filled by input_manager.cpp
+extern InputQueue inputQueue;
+//paces the main loop, and every frame reads its delta time from here instead of DeltaTime
+extern FramePacer framePacer;
+
 extern Game newGame;
+extern Simulation simulation;
 extern unsigned int gameWave;
 extern unsigned int maxWave;
 
@@ -0,0 +1,436 @@
+﻿/*
+  voice_manager.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "voice_manager.h"
+#include "variables.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace {
+	constexpr float minAudibleGain = 0.02f;  // below this a voice is not worth a source
+	constexpr float stealMargin = 1.5f;      // a thief must be this much more important, stops voices flapping
+	constexpr float dyingWeight = 4.f;
+	constexpr float playerWeight = 4.f;
+	constexpr float enemyTypeWeight = 0.1f;  // per enemyType step, SUPER_FAST outranks EASY
+}
+
+uint64_t VoiceManager::toKey(const SlotHandle& enemyHandle, unsigned int wave)
+{
+	// handles of different waves come from different storages, so the wave is part of the key
+	return (uint64_t(wave) << 48) ^ (uint64_t(enemyHandle.generation) << 24) ^ enemyHandle.index;
+}
+
+void VoiceManager::playEnemy(const SlotHandle& enemyHandle, unsigned int wave, const SoundHandle& sound,
+	voiceCategory category, int enemyTypeRank, bool loop, float delay)
+{
+	const float weight = (category == voiceCategory::ENEMY_DYING) ? dyingWeight : 1.f + enemyTypeWeight * enemyTypeRank;
+
+	const uint64_t key = toKey(enemyHandle, wave);
+	auto found = enemyVoices.find(key);
+	if (found != enemyVoices.end()) {
+		startVoice(voices[found->second], sound, category, weight, loop, delay);
+		return;
+	}
+
+	Voice voice;
+	voice.enemyHandle = enemyHandle;
+	voice.wave = wave;
+	voice.isEnemy = true;
+	voice.position = sf::Vector3f(0.f, 0.f, 2000.f); // until the Ear places it
+	startVoice(voice, sound, category, weight, loop, delay);
+
+	enemyVoices[key] = voices.size();
+	voices.push_back(voice);
+}
+
+void VoiceManager::playPlayer(const SoundHandle& sound, float delay)
+{
+	Voice voice;
+	startVoice(voice, sound, voiceCategory::PLAYER, playerWeight, false, delay);
+	voices.push_back(voice);
+}
+
+void VoiceManager::startVoice(Voice& voice, const SoundHandle& sound, voiceCategory category, float weight, bool loop, float delay)
+{
+	const sf::SoundBuffer* buffer = soundCache.get(sound);
+
+	voice.sound = sound;
+	voice.category = category;
+	voice.weight = weight;
+	voice.loop = loop;
+	voice.startDelay = std::max(delay, 0.f);
+	voice.elapsed = -voice.startDelay;
+	voice.isMixed = false; // restarting a mixed voice just plays it again in the same slot
+	voice.duration = (buffer != nullptr) ? buffer->getDuration().asSeconds() : 0.f;
+
+	// a real voice restarts on its own source, nobody has to give one up
+	if (voice.source >= 0 && buffer != nullptr) {
+		sf::Sound& source = sources[voice.source];
+		source.stop();
+		source.setBuffer(*buffer);
+		source.setLoop(loop);
+		source.play();
+	}
+}
+
+void VoiceManager::stopEnemyVoices()
+{
+	for (size_t i = voices.size(); i-- > 0; ) {
+		if (voices[i].isEnemy)
+			removeVoice(i);
+	}
+}
+
+void VoiceManager::stopAll()
+{
+	for (Voice& voice : voices) {
+		makeVirtual(voice);
+		releaseMixerSlot(voice);
+	}
+	voices.clear();
+	enemyVoices.clear();
+
+	if (mixer != nullptr) {
+		// one STOP_ALL does what the STOPs still waiting would have
+		pendingCommands.erase(std::remove_if(pendingCommands.begin(), pendingCommands.end(),
+			[](const MixerCommand& command) { return command.type == mixerCommandType::STOP; }), pendingCommands.end());
+		MixerCommand command;
+		command.type = mixerCommandType::STOP_ALL;
+		postToMixer(command, true);
+	}
+}
+
+void VoiceManager::setDistanceModel(float newMinDistance, float newAttenuation)
+{
+	if (mixer != nullptr && (newMinDistance != minDistance || newAttenuation != attenuation)) {
+		MixerCommand command;
+		command.type = mixerCommandType::DISTANCE_MODEL;
+		command.x = newMinDistance;
+		command.z = newAttenuation;
+		postToMixer(command, true);
+	}
+
+	minDistance = newMinDistance;
+	attenuation = newAttenuation;
+}
+
+void VoiceManager::enableSoftwareMixer(bool isBinaural)
+{
+	if (mixer != nullptr)
+		return;
+
+	mixer = std::make_unique<SoftwareMixer>(isBinaural);
+	freeMixerSlots.reserve(SoftwareMixer::maxVoices);
+	for (size_t slot = SoftwareMixer::maxVoices; slot-- > 0; )
+		freeMixerSlots.push_back(uint32_t(slot));
+
+	MixerCommand command;
+	command.type = mixerCommandType::DISTANCE_MODEL;
+	command.x = minDistance;
+	command.z = attenuation;
+	postToMixer(command, true);
+	mixer->play();
+}
+
+void VoiceManager::releaseMixerSlot(Voice& voice)
+{
+	if (voice.mixerSlot < 0)
+		return;
+	freeMixerSlots.push_back(uint32_t(voice.mixerSlot));
+	voice.mixerSlot = -1;
+}
+
+// Commands reach the mixer in the order they were posted, nothing overtakes one that is
+// still waiting for room. One that must arrive waits in pendingCommands, the rest (PLAY,
+// POSITION) are dropped and sent again next frame.
+bool VoiceManager::postToMixer(const MixerCommand& command, bool mustArrive)
+{
+	postPendingCommands();
+	if (pendingCommands.empty() && mixer->post(command))
+		return true;
+	if (mustArrive)
+		pendingCommands.push_back(command);
+	return false;
+}
+
+void VoiceManager::postPendingCommands()
+{
+	size_t sent = 0;
+	while (sent < pendingCommands.size() && mixer->post(pendingCommands[sent]))
+		sent++;
+	pendingCommands.erase(pendingCommands.begin(), pendingCommands.begin() + sent);
+}
+
+void VoiceManager::removeVoice(size_t index)
+{
+	makeVirtual(voices[index]);
+	// a one-shot the mixer has played to the end is already gone from its slot
+	if (mixer != nullptr && voices[index].mixerSlot >= 0 && mixer->getMixedFrames() < voices[index].mixEndFrame) {
+		MixerCommand command;
+		command.type = mixerCommandType::STOP;
+		command.slot = uint32_t(voices[index].mixerSlot);
+		postToMixer(command, true);
+	}
+	releaseMixerSlot(voices[index]);
+	if (voices[index].isEnemy)
+		enemyVoices.erase(toKey(voices[index].enemyHandle, voices[index].wave));
+
+	// swap with the last one, and fix up whoever points at it
+	const size_t last = voices.size() - 1;
+	if (index != last) {
+		voices[index] = voices[last];
+		if (voices[index].isEnemy)
+			enemyVoices[toKey(voices[index].enemyHandle, voices[index].wave)] = index;
+		if (voices[index].source >= 0)
+			sourceVoice[voices[index].source] = int(index);
+	}
+	voices.pop_back();
+}
+
+void VoiceManager::makeVirtual(Voice& voice)
+{
+	if (voice.source < 0)
+		return;
+
+	sources[voice.source].stop();
+	sourceVoice[voice.source] = -1;
+	voice.source = -1;
+}
+
+void VoiceManager::makeReal(size_t index, int source)
+{
+	Voice& voice = voices[index];
+	sf::Sound& sound = sources[source];
+	voice.source = source;
+	sourceVoice[source] = int(index);
+
+	sound.setBuffer(*soundCache.get(voice.sound));
+	sound.setLoop(voice.loop);
+	sound.setRelativeToListener(!voice.isEnemy);
+	applySourceSettings(voice);
+	sound.setPlayingOffset(sf::seconds(std::max(voice.elapsed, 0.f)));
+	sound.play();
+}
+
+void VoiceManager::applySourceSettings(const Voice& voice)
+{
+	sf::Sound& sound = sources[voice.source];
+	if (voice.isEnemy) {
+		sound.setPosition(voice.position);
+		sound.setMinDistance(minDistance);
+		sound.setAttenuation(attenuation);
+	}
+	else
+		sound.setPosition(0.f, 0.f, 0.f);
+}
+
+// Same inverse distance model OpenAL uses for the real sources
+float VoiceManager::getGain(const Voice& voice) const
+{
+	if (!voice.isEnemy)
+		return 1.f;
+
+	const sf::Vector3f& p = voice.position;
+	const float distance = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+	if (distance > maxDistance) // past where enemies come from, nothing there to hear
+		return 0.f;
+	return getInverseDistanceGain(distance, minDistance, attenuation);
+}
+
+void VoiceManager::setPaused(bool shouldPause)
+{
+	if (shouldPause == paused)
+		return;
+	paused = shouldPause;
+
+	if (mixer != nullptr) {
+		if (paused)
+			mixer->pause();
+		else
+			mixer->play();
+		return;
+	}
+
+	for (size_t s = 0; s < sources.size(); s++) {
+		if (sourceVoice[s] < 0)
+			continue;
+		if (paused && sources[s].getStatus() == sf::SoundSource::Playing)
+			sources[s].pause();
+		else if (!paused && sources[s].getStatus() == sf::SoundSource::Paused)
+			sources[s].play();
+	}
+}
+
+void VoiceManager::update(float frameDeltaTime)
+{
+	PROFILE_SCOPE("VoiceManager::update");
+
+	if (paused)
+		return;
+
+	if (mixer != nullptr) {
+		updateMixed(frameDeltaTime);
+		return;
+	}
+
+	if (sources.empty()) {
+		sources.resize(maxRealVoices);
+		sourceVoice.assign(maxRealVoices, -1);
+	}
+
+	// advance every voice, real or not, and let finished one-shots go
+	for (size_t i = voices.size(); i-- > 0; ) {
+		Voice& voice = voices[i];
+		voice.elapsed += frameDeltaTime;
+
+		// never loaded, or unloaded since
+		if (voice.duration <= 0.f || soundCache.get(voice.sound) == nullptr) {
+			removeVoice(i);
+			continue;
+		}
+		if (voice.loop)
+			voice.elapsed = fmodf(voice.elapsed, voice.duration);
+		else if (voice.elapsed >= voice.duration ||
+			(voice.source >= 0 && sources[voice.source].getStatus() == sf::SoundSource::Stopped)) {
+			removeVoice(i);
+			continue;
+		}
+
+		const float gain = getGain(voice);
+		voice.priority = (gain < minAudibleGain) ? 0.f : gain * voice.weight;
+
+		// too far to hear, give the source back
+		if (voice.priority == 0.f && voice.source >= 0) {
+			makeVirtual(voice);
+			stats.virtualizedTotal++;
+		}
+	}
+
+	// the most important virtual voices try to get a source, best first
+	candidates.clear();
+	for (size_t i = 0; i < voices.size(); i++) {
+		if (voices[i].source < 0 && voices[i].priority > 0.f)
+			candidates.push_back(i);
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+		return voices[a].priority > voices[b].priority;
+	});
+
+	for (size_t candidate : candidates) {
+		int source = -1;
+		for (size_t s = 0; s < maxRealVoices; s++) {
+			if (sourceVoice[s] < 0) {
+				source = int(s);
+				break;
+			}
+		}
+
+		if (source < 0) {
+			// all taken, steal from the least important one if this is clearly worth more
+			int victim = -1;
+			for (size_t s = 0; s < maxRealVoices; s++) {
+				if (victim < 0 || voices[sourceVoice[s]].priority < voices[sourceVoice[victim]].priority)
+					victim = int(s);
+			}
+			Voice& victimVoice = voices[sourceVoice[victim]];
+			if (voices[candidate].priority <= victimVoice.priority * stealMargin)
+				break; // the rest are even less important
+
+			makeVirtual(victimVoice);
+			stats.stolenTotal++;
+			stats.virtualizedTotal++;
+			source = victim;
+		}
+
+		makeReal(candidate, source);
+	}
+
+	stats.realVoices = 0;
+	for (const Voice& voice : voices) {
+		if (voice.source >= 0) {
+			applySourceSettings(voice);
+			stats.realVoices++;
+		}
+	}
+	stats.virtualVoices = unsigned(voices.size()) - stats.realVoices;
+}
+
+// Software mixer backend, nothing to prioritize, only commands to send
+void VoiceManager::updateMixed(float frameDeltaTime)
+{
+	// one block past what is already mixed, so a voice started now is never late
+	const uint64_t mixedFrames = mixer->getMixedFrames();
+	const uint64_t frameStart = mixedFrames + SoftwareMixer::blockFrames;
+
+	postPendingCommands();
+
+	for (size_t i = voices.size(); i-- > 0; ) {
+		Voice& voice = voices[i];
+		voice.elapsed += frameDeltaTime;
+
+		// once sent, a one-shot ends on the mixer's clock, the one its start was set on
+		const bool isOver = !voice.loop && (voice.isMixed ? mixedFrames >= voice.mixEndFrame : voice.elapsed >= voice.duration);
+		const sf::SoundBuffer* buffer = soundCache.get(voice.sound);
+		if (voice.duration <= 0.f || buffer == nullptr || isOver) {
+			removeVoice(i);
+			continue;
+		}
+
+		if (!voice.isMixed) {
+			if (voice.mixerSlot < 0) {
+				if (freeMixerSlots.empty())
+					continue; // every slot is taken, it gets one when another voice ends
+				voice.mixerSlot = int(freeMixerSlots.back());
+				freeMixerSlots.pop_back();
+			}
+
+			MixerCommand command;
+			command.type = mixerCommandType::PLAY;
+			command.slot = uint32_t(voice.mixerSlot);
+			command.samples = buffer->getSamples();
+			command.channelCount = uint16_t(buffer->getChannelCount());
+			command.frameCount = uint32_t(buffer->getSampleCount() / command.channelCount);
+			command.sampleRate = buffer->getSampleRate();
+			command.loop = voice.loop;
+			command.isRelative = !voice.isEnemy;
+			command.startFrame = frameStart + uint64_t(voice.startDelay * SoftwareMixer::outputRate);
+			command.x = voice.position.x;
+			command.z = voice.position.z;
+			voice.isMixed = postToMixer(command, false); // a full ring tries again next frame
+			if (voice.isMixed) {
+				const uint64_t outputFrames = (uint64_t(command.frameCount) * SoftwareMixer::outputRate + command.sampleRate - 1) / command.sampleRate;
+				voice.mixEndFrame = voice.loop ? UINT64_MAX : command.startFrame + outputFrames;
+				voice.mixedPosition = voice.position;
+			}
+			continue;
+		}
+
+		// the mixer keeps the last position, an enemy standing still costs nothing
+		if (voice.isEnemy && (voice.position.x != voice.mixedPosition.x || voice.position.z != voice.mixedPosition.z)) {
+			MixerCommand command;
+			command.type = mixerCommandType::POSITION;
+			command.slot = uint32_t(voice.mixerSlot);
+			command.x = voice.position.x;
+			command.z = voice.position.z;
+			if (postToMixer(command, false))
+				voice.mixedPosition = voice.position;
+		}
+	}
+
+	stats.realVoices = unsigned(voices.size());
+	stats.virtualVoices = 0;
+	stats.mixNsPerVoiceBlock = mixer->getNsPerVoiceBlock();
+}
@@ -0,0 +1,148 @@
+﻿/*
+  voice_manager.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "SFML/Audio.hpp"
+#include "slot_map.h"
+#include "sound.h"
+#include "software_mixer.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+
+enum class voiceCategory {
+	ENEMY_BLINK, ENEMY_DYING, PLAYER
+};
+
+struct VoiceStats {
+	unsigned int realVoices = 0;     // playing on an OpenAL source right now
+	unsigned int virtualVoices = 0;  // still running, but silent until a source frees up
+	unsigned int stolenTotal = 0;    // sources taken from a quieter voice that was still playing
+	unsigned int virtualizedTotal = 0;
+	float mixNsPerVoiceBlock = 0.f;  // software mixer only
+};
+
+// Every sound the game wants to play is a voice, but only maxRealVoices of them get
+// an actual sf::Sound. The rest keep their playback time running as virtual voices and
+// take over a source when it frees up, or steal one from a clearly less important voice.
+// Importance is the voice's gain at its distance times a weight for what it is
+// (dying and player sounds first, then the faster enemy types).
+// With the software mixer enabled there is no cap: every voice is sent to the mixer
+// thread, starting delay seconds into the frame, and nothing is virtual.
+class VoiceManager
+{
+public:
+	static constexpr size_t maxRealVoices = 32;
+
+	// Replaces whatever that enemy was playing, like restarting its own sf::Sound used to
+	void playEnemy(const SlotHandle& enemyHandle, unsigned int wave, const SoundHandle& sound,
+		voiceCategory category, int enemyTypeRank, bool loop, float delay = 0.f);
+	void playPlayer(const SoundHandle& sound, float delay = 0.f);
+
+	// Before anything plays; for the rest of the run every voice goes through the mixer
+	// isBinaural convolves the enemy voices with HRTFs instead of panning them
+	void enableSoftwareMixer(bool isBinaural = false);
+	bool isSoftwareMixing() const { return mixer != nullptr; }
+
+	void stopEnemyVoices();
+	void stopAll();
+
+	// A paused voice neither plays nor advances, update() does nothing until it is resumed
+	void setPaused(bool shouldPause);
+	bool isPaused() const { return paused; }
+
+	// attenuation of every enemy voice, the overlay view hears closer than the top view
+	void setDistanceModel(float newMinDistance, float newAttenuation);
+
+	// locate(handle, wave, position) writes where that enemy is heard from, and returns
+	// false once it is gone, which ends its voice
+	template<typename Locate>
+	void positionEnemyVoices(Locate locate);
+
+	// Once per rendered frame, after the positions are in
+	void update(float frameDeltaTime);
+
+	const VoiceStats& getStats() const { return stats; }
+
+private:
+	struct Voice {
+		SlotHandle enemyHandle;
+		unsigned int wave = 0;
+		bool isEnemy = false;
+		voiceCategory category = voiceCategory::ENEMY_BLINK;
+		float weight = 1.f;
+
+		SoundHandle sound;
+		bool loop = false;
+		float elapsed = 0.f;  // kept running while virtual, so it resumes where it would be; negative until it starts
+		float duration = 0.f;
+		float startDelay = 0.f;
+
+		sf::Vector3f position;
+		float priority = 0.f;
+		int source = -1;      // index into sources, -1 while virtual
+
+		int mixerSlot = -1;   // picked when it is first sent to the mixer
+		bool isMixed = false; // PLAY has been sent to the mixer
+		uint64_t mixEndFrame = UINT64_MAX;  // a one-shot is done once the mixer is past this frame
+		sf::Vector3f mixedPosition;         // last position the mixer got
+	};
+
+	static uint64_t toKey(const SlotHandle& enemyHandle, unsigned int wave);
+
+	void startVoice(Voice& voice, const SoundHandle& sound, voiceCategory category, float weight, bool loop, float delay);
+	void removeVoice(size_t index);
+	void makeVirtual(Voice& voice);
+	void makeReal(size_t index, int source);
+	void applySourceSettings(const Voice& voice);
+	float getGain(const Voice& voice) const;
+	void updateMixed(float frameDeltaTime);
+	void releaseMixerSlot(Voice& voice);
+	bool postToMixer(const MixerCommand& command, bool mustArrive);
+	void postPendingCommands();
+
+	std::vector<Voice> voices;
+	std::unordered_map<uint64_t, size_t> enemyVoices; // enemy -> index into voices
+
+	std::vector<sf::Sound> sources;  // created on first use, so a headless run never opens the device
+	std::vector<int> sourceVoice;    // voice index playing on each source, -1 if free
+	std::vector<size_t> candidates;
+
+	bool paused = false;
+
+	float minDistance = 500.f;
+	float attenuation = 0.3f;
+
+	std::unique_ptr<SoftwareMixer> mixer;
+	std::vector<uint32_t> freeMixerSlots;
+	// commands that found the ring full but must not get lost, they go before anything new
+	std::vector<MixerCommand> pendingCommands;
+
+	VoiceStats stats;
+};
+
+template<typename Locate>
+void VoiceManager::positionEnemyVoices(Locate locate)
+{
+	for (size_t i = voices.size(); i-- > 0; ) {
+		Voice& voice = voices[i];
+		if (!voice.isEnemy)
+			continue;
+		if (!locate(voice.enemyHandle, voice.wave, voice.position))
+			removeVoice(i);
+	}
+}
@@ -0,0 +1,285 @@
+﻿/*
+  wave_format.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "wave_format.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+
+
+namespace {
+
+	constexpr unsigned int maxScriptWave = 1024;
+	constexpr int maxDirection = 4;  // directionType::RIGHT
+	constexpr int maxEnemyType = 6;  // enemyType::SUPER_FAST
+	constexpr int defaultEnemyType = 2; // enemyType::MODERATE
+
+	bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+	// Cursor over one line of the script, never reads past lineEnd
+	struct LineReader {
+		const char* cursor;
+		const char* lineEnd;
+
+		void skipBlanks()
+		{
+			while (cursor < lineEnd && isBlank(*cursor))
+				++cursor;
+		}
+
+		bool atEnd()
+		{
+			skipBlanks();
+			return cursor == lineEnd;
+		}
+
+		// next whitespace separated word
+		bool readWord(const char*& word, size_t& length)
+		{
+			skipBlanks();
+			word = cursor;
+			while (cursor < lineEnd && !isBlank(*cursor))
+				++cursor;
+			length = size_t(cursor - word);
+			return length > 0;
+		}
+
+		bool readInt(long& value)
+		{
+			const char* word;
+			size_t length;
+			if (!readWord(word, length))
+				return false;
+
+			char digits[32];
+			if (length >= sizeof(digits))
+				return false;
+			memcpy(digits, word, length);
+			digits[length] = '\0';
+
+			char* parsedEnd;
+			value = strtol(digits, &parsedEnd, 10);
+			return parsedEnd == digits + length;
+		}
+	};
+
+	bool wordIs(const char* word, size_t length, const char* command)
+	{
+		const size_t commandLength = strlen(command);
+		if (length != commandLength)
+			return false;
+		for (size_t i = 0; i < length; i++) {
+			char c = word[i];
+			if (c >= 'A' && c <= 'Z')
+				c = char(c - 'A' + 'a');
+			if (c != command[i])
+				return false;
+		}
+		return true;
+	}
+
+	template<typename T>
+	void append(std::vector<unsigned char>& binary, const T& value)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+		binary.insert(binary.end(), bytes, bytes + sizeof(T));
+	}
+
+}
+
+bool compileWaveScript(const char* text, size_t length, std::vector<unsigned char>& binary, std::string& error)
+{
+	std::vector<std::vector<SpawnRecord>> waves(1);
+	unsigned int currentWave = 0;
+
+	const char* const textEnd = text + length;
+	int lineNumber = 0;
+	for (const char* lineStart = text; lineStart < textEnd; ) {
+		const char* lineEnd = static_cast<const char*>(memchr(lineStart, '\n', size_t(textEnd - lineStart)));
+		if (lineEnd == nullptr)
+			lineEnd = textEnd;
+		++lineNumber;
+
+		LineReader line{ lineStart, lineEnd };
+		lineStart = lineEnd + 1;
+
+		if (line.atEnd())
+			continue;
+		if (lineEnd - line.cursor >= 2 && line.cursor[0] == '/' && line.cursor[1] == '/')
+			continue;
+
+		const char* command;
+		size_t commandLength;
+		line.readWord(command, commandLength);
+
+		// wave <number>
+		if (wordIs(command, commandLength, "wave")) {
+			long wave;
+			if (!line.readInt(wave) || wave < 0 || wave > long(maxScriptWave)) {
+				error = "line " + std::to_string(lineNumber) + ": wave needs a number between 0 and " + std::to_string(maxScriptWave);
+				return false;
+			}
+			currentWave = unsigned(wave);
+			if (waves.size() <= currentWave)
+				waves.resize(size_t(currentWave) + 1);
+		}
+
+		// @ <direction> <type> <start time>
+		else if (wordIs(command, commandLength, "@")) {
+			long direction, type, startTime;
+			if (!line.readInt(direction) || !line.readInt(type) || !line.readInt(startTime)) {
+				error = "line " + std::to_string(lineNumber) + ": @ needs a direction, an enemy type and a start time";
+				return false;
+			}
+			if (type == 0)
+				type = defaultEnemyType;
+			if (direction < 1 || direction > maxDirection || type < 1 || type > maxEnemyType || startTime < 0) {
+				error = "line " + std::to_string(lineNumber) + ": direction, enemy type or start time out of range";
+				return false;
+			}
+
+			SpawnRecord record{};
+			record.direction = uint8_t(direction);
+			record.type = uint8_t(type);
+			record.startTime = float(startTime);
+			waves[currentWave].push_back(record);
+		}
+
+		else {
+			error = "line " + std::to_string(lineNumber) + ": invalid command '" + std::string(command, commandLength) + "'";
+			return false;
+		}
+	}
+
+	uint32_t recordCount = 0;
+	for (const std::vector<SpawnRecord>& wave : waves)
+		recordCount += uint32_t(wave.size());
+
+	WaveFileHeader header{};
+	memcpy(header.magic, waveFileMagic, sizeof(header.magic));
+	header.version = waveFileVersion;
+	header.waveCount = uint32_t(waves.size());
+	header.recordCount = recordCount;
+
+	binary.clear();
+	binary.reserve(sizeof(WaveFileHeader) + waves.size() * sizeof(WaveTableEntry) + recordCount * sizeof(SpawnRecord));
+	append(binary, header);
+
+	uint32_t firstRecord = 0;
+	for (const std::vector<SpawnRecord>& wave : waves) {
+		append(binary, WaveTableEntry{ firstRecord, uint32_t(wave.size()) });
+		firstRecord += uint32_t(wave.size());
+	}
+	for (const std::vector<SpawnRecord>& wave : waves) {
+		for (const SpawnRecord& record : wave)
+			append(binary, record);
+	}
+
+	return true;
+}
+
+bool compileWaveScriptFile(const char* textPath, const char* binaryPath, std::string& error)
+{
+	std::ifstream textStream{ textPath, std::ios::binary };
+	if (!textStream) {
+		error = std::string("can't open ") + textPath;
+		return false;
+	}
+	const std::string text{ std::istreambuf_iterator<char>(textStream), std::istreambuf_iterator<char>() };
+
+	std::vector<unsigned char> binary;
+	if (!compileWaveScript(text.data(), text.size(), binary, error)) {
+		error = std::string(textPath) + ", " + error;
+		return false;
+	}
+
+	std::ofstream binaryStream{ binaryPath, std::ios::binary | std::ios::trunc };
+	if (!binaryStream.write(reinterpret_cast<const char*>(binary.data()), std::streamsize(binary.size()))) {
+		error = std::string("can't write ") + binaryPath;
+		return false;
+	}
+	return true;
+}
+
+bool WaveFile::open(const char* binaryPath)
+{
+	close();
+
+	if (!mapping.open(binaryPath))
+		return false;
+	if (!validate(mapping.data(), mapping.size())) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool WaveFile::openFromMemory(std::vector<unsigned char>&& binary)
+{
+	close();
+
+	ownedBytes = std::move(binary);
+	if (!validate(ownedBytes.data(), ownedBytes.size())) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void WaveFile::close()
+{
+	mapping.close();
+	ownedBytes.clear();
+	header = nullptr;
+	table = nullptr;
+	records = nullptr;
+}
+
+// Only the sizes are checked here, every record is trusted after that
+bool WaveFile::validate(const unsigned char* bytes, size_t size)
+{
+	if (size < sizeof(WaveFileHeader))
+		return false;
+
+	const WaveFileHeader* newHeader = reinterpret_cast<const WaveFileHeader*>(bytes);
+	if (memcmp(newHeader->magic, waveFileMagic, sizeof(waveFileMagic)) != 0 || newHeader->version != waveFileVersion)
+		return false;
+
+	const size_t expectedSize = sizeof(WaveFileHeader) + size_t(newHeader->waveCount) * sizeof(WaveTableEntry) +
+		size_t(newHeader->recordCount) * sizeof(SpawnRecord);
+	if (size != expectedSize)
+		return false;
+
+	const WaveTableEntry* newTable = reinterpret_cast<const WaveTableEntry*>(bytes + sizeof(WaveFileHeader));
+	for (uint32_t i = 0; i < newHeader->waveCount; i++) {
+		if (uint64_t(newTable[i].firstRecord) + newTable[i].recordCount > newHeader->recordCount)
+			return false;
+	}
+
+	header = newHeader;
+	table = newTable;
+	records = reinterpret_cast<const SpawnRecord*>(newTable + newHeader->waveCount);
+	return true;
+}
+
+const SpawnRecord* WaveFile::getWave(unsigned int wave, size_t& count) const
+{
+	if (header == nullptr || wave >= header->waveCount) {
+		count = 0;
+		return nullptr;
+	}
+	count = table[wave].recordCount;
+	return records + table[wave].firstRecord;
+}
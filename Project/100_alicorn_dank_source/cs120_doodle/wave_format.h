@@ -0,0 +1,86 @@
+﻿/*
+  wave_format.h
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#pragma once
+
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+// Compiled form of scripts/script.txt. All fields are little endian.
+//
+//   WaveFileHeader
+//   WaveTableEntry[waveCount]    indexed by wave number, wave 0 is normally empty
+//   SpawnRecord[recordCount]     grouped by wave, in script order within a wave
+//
+// The text script stays the source, wave_compiler (or the game itself, when the
+// binary is missing or older than the text) turns it into this.
+
+constexpr char waveFileMagic[4] = { 'D', 'W', 'A', 'V' };
+constexpr uint32_t waveFileVersion = 1;
+
+struct WaveFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t waveCount;
+	uint32_t recordCount;
+};
+
+struct WaveTableEntry {
+	uint32_t firstRecord;
+	uint32_t recordCount;
+};
+
+struct SpawnRecord {
+	uint8_t direction; // directionType
+	uint8_t type;      // enemyType, 0 in the script is already turned into MODERATE
+	uint16_t reserved;
+	float startTime;   // seconds after the wave starts
+};
+
+static_assert(sizeof(WaveFileHeader) == 16, "wave file layout changed, bump waveFileVersion");
+static_assert(sizeof(WaveTableEntry) == 8, "wave file layout changed, bump waveFileVersion");
+static_assert(sizeof(SpawnRecord) == 8, "wave file layout changed, bump waveFileVersion");
+
+// Parses the text script in one pass. On failure returns false and describes the
+// offending line in error.
+bool compileWaveScript(const char* text, size_t length, std::vector<unsigned char>& binary, std::string& error);
+bool compileWaveScriptFile(const char* textPath, const char* binaryPath, std::string& error);
+
+// Read-only view of a compiled wave file, either mapped from disk or compiled in memory
+class WaveFile
+{
+public:
+	bool open(const char* binaryPath);
+	bool openFromMemory(std::vector<unsigned char>&& binary);
+	void close();
+
+	bool isOpen() const { return header != nullptr; }
+	unsigned int getWaveCount() const { return (header != nullptr) ? header->waveCount : 0; }
+
+	// records of one wave, count is 0 for a wave the script does not define
+	const SpawnRecord* getWave(unsigned int wave, size_t& count) const;
+
+private:
+	bool validate(const unsigned char* bytes, size_t size);
+
+	MappedFile mapping;
+	std::vector<unsigned char> ownedBytes;
+
+	const WaveFileHeader* header = nullptr;
+	const WaveTableEntry* table = nullptr;
+	const SpawnRecord* records = nullptr;
+};
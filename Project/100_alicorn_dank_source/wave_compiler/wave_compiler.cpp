@@ -0,0 +1,60 @@
+﻿/*
+  wave_compiler.cpp
+
+  GAM100 Prototype II
+  Fall 2019
+
+  YoonKi Kim
+  DoYoon Kim wrote all
+  SeungGeon Kim
+
+  All content © 2019 DigiPen (USA) Corporation, all vectors reserved.
+*/
+
+#include "wave_format.h"
+#include <iostream>
+#include <string>
+
+
+
+// wave_compiler <script.txt> [<script.waves>]
+// Turns the text wave script into the binary the game maps at startup.
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3) {
+		std::cerr << "usage: wave_compiler <script.txt> [<script.waves>]\n";
+		return 2;
+	}
+
+	const std::string textPath = argv[1];
+	std::string binaryPath;
+	if (argc == 3)
+		binaryPath = argv[2];
+	else {
+		const size_t extension = textPath.find_last_of('.');
+		const size_t directory = textPath.find_last_of("/\\");
+		const bool hasExtension = extension != std::string::npos && (directory == std::string::npos || extension > directory);
+		binaryPath = (hasExtension ? textPath.substr(0, extension) : textPath) + ".waves";
+	}
+
+	std::string error;
+	if (!compileWaveScriptFile(textPath.c_str(), binaryPath.c_str(), error)) {
+		std::cerr << "wave_compiler: " << error << "\n";
+		return 1;
+	}
+
+	WaveFile compiled;
+	if (!compiled.open(binaryPath.c_str())) {
+		std::cerr << "wave_compiler: " << binaryPath << " does not read back\n";
+		return 1;
+	}
+
+	size_t totalRecords = 0;
+	for (unsigned int wave = 0; wave < compiled.getWaveCount(); wave++) {
+		size_t count = 0;
+		compiled.getWave(wave, count);
+		totalRecords += count;
+	}
+	std::cout << binaryPath << ": " << compiled.getWaveCount() << " waves, " << totalRecords << " spawns\n";
+	return 0;
+}